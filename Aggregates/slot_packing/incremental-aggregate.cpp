@@ -0,0 +1,188 @@
+/**
+ * @file incremental-aggregate.cpp
+ * @author Bernardo Ramalho
+ * @brief Keeps encrypted running sums of append-only data, so each new batch is encrypted once and the mean and variance can be queried at any time
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../../includes/encryptedAggregate.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::string command, int64_t count, std::vector<double> processingTimes, uint64_t bytes, double value){
+    std::ofstream aggregatesCSV("timeCSVs/aggregates.csv", std::ios_base::app);
+    std::cout.rdbuf(aggregatesCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\n" << command << ", " << count << ", ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+
+    std::cout << bytes << ", " << value << std::endl;
+
+    aggregatesCSV.close();
+}
+
+int init(const std::string& aggregate_path){
+    EncryptedAggregate aggregate;
+    aggregate.save(aggregate_path);
+
+    std::cout << "Empty aggregate written to " << aggregate_path << std::endl;
+
+    return 0;
+}
+
+// Encrypt only the numbers of the new file and fold them into the aggregate
+int append(const std::string& keys_directory, const std::string& aggregate_path, const std::string& numbers_path){
+    // Read the vector from a file
+    std::ifstream numbers_file (numbers_path);
+
+    if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << numbers_path << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    TimeVar t;
+    // Setup, append and save
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // The public key encrypts the batch and the relinearization key is used for its squares
+    CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    EncryptedAggregate aggregate(aggregate_path);
+
+    processingTimes[0] = TOC(t);
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+    aggregate.append(cryptoContext, publicKey, all_numbers, layout);
+    processingTimes[1] = TOC(t);
+    std::cout << "Duration of encryption and homomorphic operations: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+    uint64_t bytes = aggregate.save(aggregate_path);
+    processingTimes[2] = TOC(t);
+    std::cout << "Duration of serialization: " << processingTimes[2] << "ms" << std::endl;
+
+    std::cout << "Appended: " << all_numbers.size() << std::endl;
+    std::cout << "Count: " << aggregate.count() << std::endl;
+
+    printIntoCSV("append", aggregate.count(), processingTimes, bytes, all_numbers.size());
+
+    return 0;
+}
+
+int query(const std::string& keys_directory, const std::string& aggregate_path, const std::string& statistic){
+    TimeVar t;
+    // Setup, homomorphic operations, decryption
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+    PrivateKey<DCRTPoly> secretKey = load_secret_key(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    // The sums can only be decrypted with the keys they were encrypted with
+    EncryptedAggregate aggregate(aggregate_path);
+    aggregate.checkKeys(cryptoContext, publicKey);
+
+    processingTimes[0] = TOC(t);
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    // Homomorphic Operations
+    // Only one rotate and sum, however much data was appended
+    TIC(t);
+    Ciphertext<DCRTPoly> result = aggregate.evaluate(cryptoContext, statistic, layout);
+    processingTimes[1] = TOC(t);
+    std::cout << "Duration of homomorphic operations: " << processingTimes[1] << "ms" << std::endl;
+
+    // Decryption
+    TIC(t);
+    Plaintext plaintextResult;
+    cryptoContext->Decrypt(secretKey, result, &plaintextResult);
+    processingTimes[2] = TOC(t);
+    std::cout << "Duration of decryption: " << processingTimes[2] << "ms" << std::endl;
+
+    double value = finish_statistic(statistic, plaintextResult->GetPackedValue(), layout, aggregate.count());
+
+    std::cout << "Count: " << aggregate.count() << std::endl;
+    std::cout << statistic << ": " << value << std::endl;
+
+    printIntoCSV(statistic, aggregate.count(), processingTimes, 0, value);
+
+    return 0;
+}
+
+/*
+ * The keys directory is created by "encryptor keygen" (ClientServer)
+ *
+ * argv[1] --> "init", "append" or "query"
+ *
+ * init:
+ *   argv[2] --> aggregate file
+ *
+ * append:
+ *   argv[2] --> keys directory
+ *   argv[3] --> aggregate file
+ *   argv[4] --> number's file name, with the new values
+ *
+ * query:
+ *   argv[2] --> keys directory
+ *   argv[3] --> aggregate file
+ *   argv[4] --> statistic (mean or variance)
+*/
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    try{
+        if(mode == "init" && argc > 2){
+            return init(argv[2]);
+        }
+
+        if(mode == "append" && argc > 4){
+            return append(argv[2], argv[3], argv[4]);
+        }
+
+        if(mode == "query" && argc > 4){
+            return query(argv[2], argv[3], argv[4]);
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " init <aggregate file>" << std::endl;
+    std::cerr << "       " << argv[0] << " append <keys directory> <aggregate file> <numbers file>" << std::endl;
+    std::cerr << "       " << argv[0] << " query <keys directory> <aggregate file> <mean|variance>" << std::endl;
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file decryptor.cpp
+ * @author Bernardo Ramalho
+ * @brief Data owner side: decrypts the result container written by the evaluator
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/ciphertextContainer.h"
+#include "../includes/homomorphicStatistics.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(uint64_t bytes_in, uint64_t bytes_out, double deserialize_time, double crypto_time, double serialize_time){
+    std::ofstream ioCSV("timeCSVs/io.csv", std::ios_base::app);
+    std::cout.rdbuf(ioCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\ndecryptor, " << bytes_in << ", " << bytes_out << ", " << deserialize_time << ", " << crypto_time << ", " << serialize_time << std::endl;
+
+    ioCSV.close();
+}
+
+// Decrypt the result container and finish the statistic
+int decrypt(const std::string& keys_directory, const std::string& result_path){
+    TimeVar t;
+
+    TIC(t);
+    CryptoContext<DCRTPoly> cryptoContext = load_crypto_context(keys_directory);
+    PrivateKey<DCRTPoly> secretKey = load_secret_key(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+    double setup_time = TOC(t);
+
+    // Deserialization, straight from the mapped container
+    TIC(t);
+    CiphertextContainer input(result_path);
+    Ciphertext<DCRTPoly> result = input.get(0);
+    double deserialize_time = TOC(t);
+
+    std::string statistic = input.getMetadata("statistic");
+    int64_t total_elements = std::stoll(input.getMetadata("total_elements"));
+
+    // Decryption
+    TIC(t);
+    Plaintext plaintextResult;
+    cryptoContext->Decrypt(secretKey, result, &plaintextResult);
+    double decryption_time = TOC(t);
+
+    // Plaintext Operations
+    double value = finish_statistic(statistic, plaintextResult->GetPackedValue(), layout, total_elements);
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+    std::cout << "Duration of deserialization: " << deserialize_time << "ms" << std::endl;
+    std::cout << "Duration of decryption: " << decryption_time << "ms" << std::endl;
+    std::cout << "Bytes read: " << input.bytes() << std::endl;
+    std::cout << statistic << ": " << value << std::endl;
+
+    printIntoCSV(input.bytes(), 0, deserialize_time, decryption_time, 0);
+
+    return 0;
+}
+
+/*
+ * argv[1] --> keys directory
+ * argv[2] --> result container, written by the evaluator
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " <keys directory> <result container>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A missing or corrupt keys directory or container is reported instead of terminating
+    try{
+        return decrypt(argv[1], argv[2]);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file encryptor.cpp
+ * @author Bernardo Ramalho
+ * @brief Data owner side: generates the keys and encrypts a number file into a ciphertext container
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/ciphertextContainer.h"
+#include "../includes/homomorphicStatistics.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(uint64_t bytes_in, uint64_t bytes_out, double deserialize_time, double crypto_time, double serialize_time){
+    std::ofstream ioCSV("timeCSVs/io.csv", std::ios_base::app);
+    std::cout.rdbuf(ioCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nencryptor, " << bytes_in << ", " << bytes_out << ", " << deserialize_time << ", " << crypto_time << ", " << serialize_time << std::endl;
+
+    ioCSV.close();
+}
+
+int keygen(const std::string& keys_directory){
+    TimeVar t;
+    TIC(t);
+
+    CryptoContext<DCRTPoly> cryptoContext = make_statistics_context();
+    KeyPair<DCRTPoly> keyPair = generate_statistics_keys(cryptoContext);
+
+    save_keys(keys_directory, cryptoContext, keyPair);
+
+    std::cout << "Duration of setup: " << TOC(t) << "ms" << std::endl;
+    std::cout << "Keys written to " << keys_directory << std::endl;
+
+    return 0;
+}
+
+int encrypt(const std::string& keys_directory, const std::string& numbers_path, const std::string& output_path, const std::string& format){
+    // Read the vector from a file
+    std::ifstream numbers_file (numbers_path);
+
+    if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << numbers_path << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Size of the plaintext input, reported as the bytes read
+    numbers_file.seekg(0, std::ios::end);
+    uint64_t bytes_in = numbers_file.tellg();
+    numbers_file.seekg(0, std::ios::beg);
+
+    std::vector<std::vector<int64_t>> vectors;
+    int64_t number;
+
+    if(format == "lines"){
+        // Body of file is made of lines, each representing a vector (used by the inner product)
+        std::string vector_line;
+
+        while(std::getline(numbers_file, vector_line)){
+            std::istringstream line(vector_line);
+
+            std::vector<int64_t> v;
+            while (line >> number) {
+                v.push_back(number);
+            }
+
+            if(!v.empty()){
+                vectors.push_back(v);
+            }
+        }
+    }
+    else{
+        // Header of file contains information about nr of vector and the size of each of them
+        int64_t number_vectors, size_vectors;
+        std::vector<int64_t> all_numbers;
+
+        numbers_file >> number_vectors;
+        numbers_file >> size_vectors;
+
+        while (numbers_file >> number) {
+            all_numbers.push_back(number);
+        }
+
+        vectors.push_back(all_numbers);
+    }
+
+    // The inner product pairs the chunks of the first vector with the ones of the second, so they must have the same length
+    if(vectors.empty() || vectors[0].empty()){
+        std::cerr << "No numbers in the file - '" << numbers_path << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for(size_t v = 1; v < vectors.size(); v++){
+        if(vectors[v].size() != vectors[0].size()){
+            std::cerr << "Vector " << v << " has " << vectors[v].size() << " numbers but vector 0 has " << vectors[0].size() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    TimeVar t;
+
+    // Only the context and the public key are needed to encrypt
+    TIC(t);
+    CryptoContext<DCRTPoly> cryptoContext = load_crypto_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+    double setup_time = TOC(t);
+
+    // Encryption
+    TIC(t);
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(size_t v = 0; v < vectors.size(); v++){
+        std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(vectors[v], layout.segment_width, layout.row_size);
+
+        for(size_t i = 0; i < packed_numbers.size(); i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+            ciphertexts.push_back(cryptoContext->Encrypt(publicKey, plaintext));
+        }
+    }
+    double encryption_time = TOC(t);
+
+    // Serialization
+    TIC(t);
+    ContainerMetadata metadata;
+    metadata["total_elements"] = std::to_string(vectors[0].size());
+    metadata["number_vectors"] = std::to_string(vectors.size());
+
+    ContainerWriter writer(output_path, metadata, ciphertexts.size());
+    for(size_t i = 0; i < ciphertexts.size(); i++){
+        writer.add(ciphertexts[i]);
+    }
+    uint64_t bytes_out = writer.finish();
+    double serialize_time = TOC(t);
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+    std::cout << "Duration of encryption: " << encryption_time << "ms" << std::endl;
+    std::cout << "Duration of serialization: " << serialize_time << "ms" << std::endl;
+    std::cout << "Ciphertexts: " << ciphertexts.size() << std::endl;
+    std::cout << "Bytes read: " << bytes_in << std::endl;
+    std::cout << "Bytes written: " << bytes_out << std::endl;
+
+    printIntoCSV(bytes_in, bytes_out, 0, encryption_time, serialize_time);
+
+    return 0;
+}
+
+/*
+ * argv[1] --> "keygen" or "encrypt"
+ *
+ * keygen:
+ *   argv[2] --> keys directory
+ *
+ * encrypt:
+ *   argv[2] --> keys directory
+ *   argv[3] --> number's file name
+ *   argv[4] --> output container
+ *   argv[5] --> "header" for the number_vectors/size_vectors format, "lines" for one vector per line (optional)
+*/
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    try{
+        if(mode == "keygen" && argc > 2){
+            return keygen(argv[2]);
+        }
+
+        if(mode == "encrypt" && argc > 4){
+            return encrypt(argv[2], argv[3], argv[4], argc > 5 ? argv[5] : "header");
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " keygen <keys directory>" << std::endl;
+    std::cerr << "       " << argv[0] << " encrypt <keys directory> <numbers file> <output container> [header|lines]" << std::endl;
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file evaluator.cpp
+ * @author Bernardo Ramalho
+ * @brief Evaluation side: computes a statistic over a ciphertext container without ever seeing the secret key
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/ciphertextContainer.h"
+#include "../includes/homomorphicStatistics.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(uint64_t bytes_in, uint64_t bytes_out, double deserialize_time, double crypto_time, double serialize_time){
+    std::ofstream ioCSV("timeCSVs/io.csv", std::ios_base::app);
+    std::cout.rdbuf(ioCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nevaluator, " << bytes_in << ", " << bytes_out << ", " << deserialize_time << ", " << crypto_time << ", " << serialize_time << std::endl;
+
+    ioCSV.close();
+}
+
+// Calculate the statistic over the input container and write the result into the output container
+int evaluate(const std::string& keys_directory, const std::string& input_path, const std::string& statistic,
+             const std::string& output_path, uint32_t towers_left){
+    if(!is_valid_statistic(statistic)){
+        std::cerr << "Unknown statistic '" << statistic << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TimeVar t;
+
+    TIC(t);
+    CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+    double setup_time = TOC(t);
+
+    // Deserialization, straight from the mapped container
+    TIC(t);
+    CiphertextContainer input(input_path);
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts = input.getAll();
+    double deserialize_time = TOC(t);
+
+    if(statistic == "inner-product" && input.getMetadata("number_vectors") != "2"){
+        std::cerr << "The inner product needs a container with two vectors" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Homomorphic Operations
+    TIC(t);
+    Ciphertext<DCRTPoly> result = evaluate_statistic(cryptoContext, statistic, ciphertexts, layout);
+    double evaluation_time = TOC(t);
+
+    // Switch the result down to a smaller modulus before sending it back, the result only has to be decrypted
+    size_t full_towers = result->GetElements()[0].GetNumOfElements();
+    double compression_time = 0;
+
+    if(towers_left > 0 && towers_left < full_towers){
+        TIC(t);
+        result = cryptoContext->Compress(result, towers_left);
+        compression_time = TOC(t);
+    }
+
+    // Serialization
+    TIC(t);
+    ContainerMetadata metadata;
+    metadata["statistic"] = statistic;
+    metadata["total_elements"] = input.getMetadata("total_elements");
+
+    ContainerWriter writer(output_path, metadata, 1);
+    writer.add(result);
+    uint64_t bytes_out = writer.finish();
+    double serialize_time = TOC(t);
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+    std::cout << "Duration of deserialization: " << deserialize_time << "ms" << std::endl;
+    std::cout << "Duration of homomorphic operations: " << evaluation_time << "ms" << std::endl;
+    std::cout << "Duration of compression: " << compression_time << "ms" << std::endl;
+    std::cout << "Duration of serialization: " << serialize_time << "ms" << std::endl;
+    std::cout << "Result towers: " << result->GetElements()[0].GetNumOfElements() << " of " << full_towers << std::endl;
+    std::cout << "Bytes read: " << input.bytes() << std::endl;
+    std::cout << "Bytes written: " << bytes_out << std::endl;
+
+    printIntoCSV(input.bytes(), bytes_out, deserialize_time, evaluation_time, serialize_time);
+
+    return 0;
+}
+
+/*
+ * argv[1] --> keys directory (only the context and the evaluation keys are read)
+ * argv[2] --> input container, written by the encryptor
+ * argv[3] --> statistic (mean, inner-product or variance)
+ * argv[4] --> output container with the result ciphertext
+ * argv[5] --> number of RNS towers to keep in the result, 0 keeps the full modulus (optional, default 0)
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 5){
+        std::cerr << "Usage: " << argv[0] << " <keys directory> <input container> <mean|inner-product|variance> <output container> [towers]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A missing or corrupt keys directory or container is reported instead of terminating
+    try{
+        return evaluate(argv[1], argv[2], argv[3], argv[4], argc > 5 ? std::stoi(argv[5]) : 0);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
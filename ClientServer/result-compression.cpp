@@ -0,0 +1,152 @@
+/**
+ * @file result-compression.cpp
+ * @author Bernardo Ramalho
+ * @brief Measures how much the result ciphertexts shrink and how much faster they decrypt after switching them to a smaller modulus
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/homomorphicStatistics.h"
+#include "../includes/serialization.h"
+
+using namespace lbcrypto;
+
+// Each row: statistic, full towers, compressed towers, full bytes, compressed bytes, full decryption ms, compressed decryption ms
+void printIntoCSV(std::vector<std::string> rows){
+    std::ofstream compressionCSV("timeCSVs/compression.csv", std::ios_base::app);
+    std::cout.rdbuf(compressionCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    for(unsigned int i = 0; i < rows.size(); i++){
+        std::cout << "\n" << rows[i];
+    }
+    std::cout << std::endl;
+
+    compressionCSV.close();
+}
+
+// Average time of decrypting the ciphertext repetitions times, the decrypted values are returned in slots
+double timeDecryption(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey, Ciphertext<DCRTPoly> ciphertext, int repetitions, std::vector<int64_t>& slots){
+    TimeVar t;
+    Plaintext plaintext;
+
+    TIC(t);
+    for(int i = 0; i < repetitions; i++){
+        cryptoContext->Decrypt(secretKey, ciphertext, &plaintext);
+    }
+    double time = TOC(t) / repetitions;
+
+    slots = plaintext->GetPackedValue();
+
+    return time;
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> number of decryptions to average (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    // Setup
+    CryptoContext<DCRTPoly> cryptoContext = make_statistics_context();
+    KeyPair<DCRTPoly> keyPair = generate_statistics_keys(cryptoContext);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    // Encryption
+    // The mean and the variance use all the numbers, the inner product multiplies the first half by the second half
+    size_t half = all_numbers.size() / 2;
+    std::vector<std::vector<int64_t>> halves = {
+        std::vector<int64_t>(all_numbers.begin(), all_numbers.begin() + half),
+        std::vector<int64_t>(all_numbers.begin() + half, all_numbers.begin() + 2 * half)
+    };
+
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts, halfCiphertexts;
+
+    std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(all_numbers, layout.segment_width, layout.row_size);
+    for(size_t i = 0; i < packed_numbers.size(); i++){
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakePackedPlaintext(packed_numbers[i])));
+    }
+
+    for(size_t h = 0; h < halves.size(); h++){
+        packed_numbers = pack_first_segment(halves[h], layout.segment_width, layout.row_size);
+        for(size_t i = 0; i < packed_numbers.size(); i++){
+            halfCiphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakePackedPlaintext(packed_numbers[i])));
+        }
+    }
+
+    std::vector<std::string> statistics = {"mean", "inner-product", "variance"};
+    std::vector<std::string> rows;
+
+    for(size_t s = 0; s < statistics.size(); s++){
+        std::string statistic = statistics[s];
+        int64_t total_elements = statistic == "inner-product" ? half : all_numbers.size();
+
+        Ciphertext<DCRTPoly> result = evaluate_statistic(cryptoContext, statistic, statistic == "inner-product" ? halfCiphertexts : ciphertexts, layout);
+
+        // Result at the full modulus
+        std::vector<int64_t> full_slots;
+        size_t full_towers = result->GetElements()[0].GetNumOfElements();
+        size_t full_bytes = serialize_ciphertext(result).size();
+        double full_time = timeDecryption(cryptoContext, keyPair.secretKey, result, repetitions, full_slots);
+
+        // Find the smallest modulus (number of towers) that still decrypts to the same values
+        Ciphertext<DCRTPoly> compressed = result;
+        std::vector<int64_t> compressed_slots;
+        size_t towers = full_towers;
+        double time = full_time;
+
+        for(size_t towers_left = 1; towers_left < full_towers; towers_left++){
+            Ciphertext<DCRTPoly> candidate = cryptoContext->Compress(result, towers_left);
+            double candidate_time = timeDecryption(cryptoContext, keyPair.secretKey, candidate, repetitions, compressed_slots);
+
+            if(compressed_slots == full_slots){
+                compressed = candidate;
+                towers = towers_left;
+                time = candidate_time;
+                break;
+            }
+        }
+
+        size_t bytes = serialize_ciphertext(compressed).size();
+
+        std::cout << statistic << ": " << finish_statistic(statistic, full_slots, layout, total_elements) << std::endl;
+        std::cout << "  Towers: " << full_towers << " -> " << towers << std::endl;
+        std::cout << "  Size: " << full_bytes << " -> " << bytes << " bytes (" << 100.0 * (full_bytes - bytes) / full_bytes << "% smaller)" << std::endl;
+        std::cout << "  Decryption: " << full_time << "ms -> " << time << "ms (" << full_time / time << "x faster)" << std::endl;
+
+        rows.push_back(statistic + ", " + std::to_string(full_towers) + ", " + std::to_string(towers) + ", " + std::to_string(full_bytes) + ", "
+                       + std::to_string(bytes) + ", " + std::to_string(full_time) + ", " + std::to_string(time));
+    }
+
+    printIntoCSV(rows);
+
+    return 0;
+}
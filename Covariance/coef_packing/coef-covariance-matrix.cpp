@@ -0,0 +1,251 @@
+/**
+ * @file coef-covariance-matrix.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the covariance and correlation matrices of k columns using coefficient packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/coefEntryLayout.h"
+#include "../../includes/partialDecryption.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, int64_t number_columns, int64_t number_decryptions, int64_t wrong_results){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream covarianceCSV("timeCSVs/covariance.csv", std::ios_base::app);
+    std::cout.rdbuf(covarianceCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\ncoef, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << number_columns << ", " << number_decryptions << ", " << wrong_results << std::endl;
+
+    covarianceCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name, each vector is one column (number_vectors columns of size_vectors values)
+ * argv[2] --> length of the chunks each column is split into, a power of 2 (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t number_columns = number_vectors;
+    std::vector<std::vector<int64_t>> columns;
+
+    for(int64_t c = 0; c < number_columns; c++){
+        columns.push_back(std::vector<int64_t>(all_numbers.begin() + c * size_vectors, all_numbers.begin() + (c + 1) * size_vectors));
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold sum(x_a * x_b)
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Entries to calculate: the sum of every column and the cross sum sum(x_a * x_b) of every pair a <= b.
+    // By default the chunks are as long as possible while still fitting all the entries in one ciphertext
+    CoefEntryLayout layout(cryptoContext, number_columns, argc > 2 ? std::stoll(argv[2]) : 0);
+
+    const std::vector<std::pair<int64_t, int64_t>>& entries = layout.getEntries();
+    int64_t number_entries = layout.numberEntries();
+    int64_t chunk_length = layout.chunkLength();
+    int64_t number_chunks = ceil((double)size_vectors / chunk_length);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key, no rotation keys are needed
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Each chunk of a column is encrypted once as it is and once reversed, the reversed copy is the second factor of the cross sums
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> columnCiphertexts(number_columns), reversedCiphertexts(number_columns);
+
+    for(int64_t c = 0; c < number_columns; c++){
+        for(int64_t i = 0; i < number_chunks; i++){
+            std::vector<int64_t> chunk(columns[c].begin() + i * chunk_length, columns[c].begin() + std::min((i + 1) * chunk_length, size_vectors));
+            chunk.resize(chunk_length, 0);
+
+            columnCiphertexts[c].push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakeCoefPackedPlaintext(chunk)));
+
+            reverse(chunk.begin(), chunk.end());
+            reversedCiphertexts[c].push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakeCoefPackedPlaintext(chunk)));
+        }
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // The chunks of each column are added before multiplying by the vector of ones, so each column sum is a single plaintext multiplication.
+    // The chunk products of each pair are added without relinearization, the layout relinearizes each result ciphertext once
+    std::vector<Ciphertext<DCRTPoly>> entryCiphertexts;
+
+    for(int64_t e = 0; e < number_entries; e++){
+        int64_t a = entries[e].first;
+        int64_t b = entries[e].second;
+
+        if(b < 0){
+            entryCiphertexts.push_back(cryptoContext->EvalAddMany(columnCiphertexts[a]));
+            continue;
+        }
+
+        std::vector<Ciphertext<DCRTPoly>> chunkProducts;
+        for(int64_t i = 0; i < number_chunks; i++){
+            chunkProducts.push_back(cryptoContext->EvalMultNoRelin(columnCiphertexts[a][i], reversedCiphertexts[b][i]));
+        }
+
+        entryCiphertexts.push_back(cryptoContext->EvalAddMany(chunkProducts));
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> resultCiphertexts = layout.placeEntries(entryCiphertexts);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // Only the coefficients holding an entry are read
+    std::vector<int64_t> entry_values;
+    std::vector<uint32_t> indexes = layout.entryIndexes();
+
+    for(unsigned int r = 0; r < resultCiphertexts.size(); r++){
+        std::vector<int64_t> values = decrypt_coefficients(cryptoContext, keyPair.secretKey, resultCiphertexts[r], indexes);
+        entry_values.insert(entry_values.end(), values.begin(), values.end());
+    }
+    entry_values.resize(number_entries);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // cov(a, b) = (n*sum(x_a * x_b) - sum(x_a)*sum(x_b))/n^2, the same formula as the second approach of the variance
+    int64_t n = size_vectors;
+    std::vector<std::vector<double>> covariance(number_columns, std::vector<double>(number_columns));
+    int64_t wrong_results = 0;
+
+    for(int64_t e = number_columns; e < number_entries; e++){
+        int64_t a = entries[e].first;
+        int64_t b = entries[e].second;
+
+        covariance[a][b] = ((long double)n * entry_values[e] - (long double)entry_values[a] * entry_values[b]) / pow(n, 2);
+        covariance[b][a] = covariance[a][b];
+
+        // Check the cross sum against the plaintext one
+        int64_t expected = 0;
+        for(int64_t i = 0; i < n; i++){
+            expected += columns[a][i] * columns[b][i];
+        }
+        wrong_results += entry_values[e] != expected;
+    }
+
+    for(int64_t a = 0; a < number_columns; a++){
+        wrong_results += entry_values[a] != std::accumulate(columns[a].begin(), columns[a].end(), (int64_t)0);
+    }
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Entries: " << number_entries << " in " << resultCiphertexts.size() << " decryptions" << std::endl;
+
+    std::cout << "Covariance:" << std::endl;
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = 0; b < number_columns; b++){
+            std::cout << " " << covariance[a][b];
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Correlation:" << std::endl;
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = 0; b < number_columns; b++){
+            std::cout << " " << covariance[a][b] / sqrt(covariance[a][a] * covariance[b][b]);
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Wrong results: " << wrong_results << std::endl;
+
+    printIntoCSV(processingTimes, total_time, number_columns, resultCiphertexts.size(), wrong_results);
+}
@@ -0,0 +1,288 @@
+/**
+ * @file covariance-matrix.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the covariance and correlation matrices of k columns using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, int64_t number_columns, int64_t number_decryptions, int64_t wrong_results){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream covarianceCSV("timeCSVs/covariance.csv", std::ios_base::app);
+    std::cout.rdbuf(covarianceCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nslot, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << number_columns << ", " << number_decryptions << ", " << wrong_results << std::endl;
+
+    covarianceCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name, each vector is one column (number_vectors columns of size_vectors values)
+ * argv[2] --> maximum number of segments of each result ciphertext (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t max_segments = argc > 2 ? std::stoll(argv[2]) : 32;
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t number_columns = number_vectors;
+    std::vector<std::vector<int64_t>> columns;
+
+    for(int64_t c = 0; c < number_columns; c++){
+        columns.push_back(std::vector<int64_t>(all_numbers.begin() + c * size_vectors, all_numbers.begin() + (c + 1) * size_vectors));
+    }
+
+    // Entries to calculate: the sum of every column and the cross sum sum(x_a * x_b) of every pair a <= b
+    std::vector<std::pair<int64_t, int64_t>> entries;
+    for(int64_t a = 0; a < number_columns; a++){
+        entries.push_back({a, -1});
+    }
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = a; b < number_columns; b++){
+            entries.push_back({a, b});
+        }
+    }
+
+    int64_t number_entries = entries.size();
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold sum(x_a * x_b)
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each entry gets its own segment, so the entries fold into as few result ciphertexts as possible
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t number_segments = std::min<int64_t>(pow(2, ceil(log2(number_entries))), std::min(max_segments, row_size));
+    int64_t segment_width = row_size / number_segments;
+
+    // The rotate and sum only has to cover one segment, and is shared by all the entries of a result ciphertext
+    int64_t number_rotations = log2(segment_width);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys of the shared rotate and sum, plus the ones that move each entry into its segment
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(number_rotations);
+    for(int64_t segment = 1; segment < number_segments; segment++){
+        rotation_indexes.push_back(segment_rotation_index(segment, segment_width, row_size));
+    }
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Each column is encrypted only once, with its values in the first segment of each row
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> columnCiphertexts(number_columns);
+
+    for(int64_t c = 0; c < number_columns; c++){
+        std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(columns[c], segment_width, row_size);
+
+        for(unsigned int i = 0; i < packed_numbers.size(); i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+            columnCiphertexts[c].push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+        }
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    std::vector<Ciphertext<DCRTPoly>> resultCiphertexts;
+
+    for(int64_t e = 0; e < number_entries; e++){
+        int64_t a = entries[e].first;
+        int64_t b = entries[e].second;
+        int64_t segment = e % number_segments;
+
+        Ciphertext<DCRTPoly> entryCiphertext;
+
+        if(b < 0){
+            // Column sum
+            entryCiphertext = cryptoContext->EvalAddMany(columnCiphertexts[a]);
+        }
+        else{
+            // Cross sum, the chunk products are only relinearized after being added together
+            std::vector<Ciphertext<DCRTPoly>> products;
+
+            for(unsigned int i = 0; i < columnCiphertexts[a].size(); i++){
+                products.push_back(cryptoContext->EvalMultNoRelin(columnCiphertexts[a][i], columnCiphertexts[b][i]));
+            }
+
+            entryCiphertext = cryptoContext->Relinearize(cryptoContext->EvalAddMany(products));
+        }
+
+        // Move the entry into its segment of the current result ciphertext
+        if(segment > 0){
+            entryCiphertext = cryptoContext->EvalRotate(entryCiphertext, segment_rotation_index(segment, segment_width, row_size));
+            resultCiphertexts.back() = cryptoContext->EvalAdd(resultCiphertexts.back(), entryCiphertext);
+        }
+        else{
+            resultCiphertexts.push_back(entryCiphertext);
+        }
+    }
+
+    // One rotate and sum per result ciphertext reduces all its entries at the same time
+    for(unsigned int i = 0; i < resultCiphertexts.size(); i++){
+        resultCiphertexts[i] = rotate_and_sum(cryptoContext, resultCiphertexts[i], number_rotations);
+    }
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    std::vector<int64_t> entry_values;
+
+    for(unsigned int i = 0; i < resultCiphertexts.size(); i++){
+        Plaintext plaintextResult;
+        cryptoContext->Decrypt(keyPair.secretKey, resultCiphertexts[i], &plaintextResult);
+
+        const std::vector<int64_t>& slots = plaintextResult->GetPackedValue();
+
+        for(int64_t segment = 0; segment < number_segments && (int64_t)entry_values.size() < number_entries; segment++){
+            entry_values.push_back(read_segment_sum(slots, segment, segment_width, row_size));
+        }
+    }
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // cov(a, b) = (n*sum(x_a * x_b) - sum(x_a)*sum(x_b))/n^2, the same formula as the second approach of the variance
+    int64_t n = size_vectors;
+    std::vector<std::vector<double>> covariance(number_columns, std::vector<double>(number_columns));
+    int64_t wrong_results = 0;
+
+    for(int64_t e = number_columns; e < number_entries; e++){
+        int64_t a = entries[e].first;
+        int64_t b = entries[e].second;
+
+        covariance[a][b] = ((long double)n * entry_values[e] - (long double)entry_values[a] * entry_values[b]) / pow(n, 2);
+        covariance[b][a] = covariance[a][b];
+
+        // Check the cross sum against the plaintext one
+        int64_t expected = 0;
+        for(int64_t i = 0; i < n; i++){
+            expected += columns[a][i] * columns[b][i];
+        }
+        wrong_results += entry_values[e] != expected;
+    }
+
+    for(int64_t a = 0; a < number_columns; a++){
+        wrong_results += entry_values[a] != std::accumulate(columns[a].begin(), columns[a].end(), (int64_t)0);
+    }
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Entries: " << number_entries << " in " << resultCiphertexts.size() << " decryptions" << std::endl;
+
+    std::cout << "Covariance:" << std::endl;
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = 0; b < number_columns; b++){
+            std::cout << " " << covariance[a][b];
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Correlation:" << std::endl;
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = 0; b < number_columns; b++){
+            std::cout << " " << covariance[a][b] / sqrt(covariance[a][a] * covariance[b][b]);
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Wrong results: " << wrong_results << std::endl;
+
+    printIntoCSV(processingTimes, total_time, number_columns, resultCiphertexts.size(), wrong_results);
+}
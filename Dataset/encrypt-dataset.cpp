@@ -0,0 +1,138 @@
+/**
+ * @file encrypt-dataset.cpp
+ * @author Bernardo Ramalho
+ * @brief Encrypts number files into an encrypted dataset on disk, so they can be queried many times without being encrypted again
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/encryptedDataset.h"
+#include "../includes/numberFileLoader.h"
+#include "../includes/resultCache.h"
+#include "../includes/threadPool.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::string command, const DatasetManifest& manifest, std::vector<double> processingTimes, uint64_t bytes){
+    std::ofstream datasetCSV("timeCSVs/dataset.csv", std::ios_base::app);
+    std::cout.rdbuf(datasetCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\n" << command << ", " << manifest.packing << ", " << manifest.generation << ", " << manifest.count() << ", ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+
+    std::cout << bytes << std::endl;
+
+    datasetCSV.close();
+}
+
+int init(const std::string& keys_directory, const std::string& dataset_directory, const std::string& packing, int64_t chunk_length){
+    CryptoContext<DCRTPoly> cryptoContext = load_crypto_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+
+    EncryptedDataset dataset = EncryptedDataset::create(dataset_directory, cryptoContext, publicKey, packing, chunk_length);
+
+    std::cout << "Empty " << packing << " dataset written to " << dataset_directory << std::endl;
+    std::cout << "Chunk length: " << dataset.getManifest().chunk_length << std::endl;
+    std::cout << "Fingerprint: " << dataset.getManifest().fingerprint << std::endl;
+
+    return 0;
+}
+
+// Encrypt the numbers of the file into a new part of the dataset
+int append(const std::string& keys_directory, const std::string& dataset_directory, const std::string& numbers_path, unsigned int number_threads,
+           const std::string& cache_directory){
+    NumberFile numbers_file = load_number_file(numbers_path, number_threads);
+
+    std::cout << "Duration of reading: " << numbers_file.milliseconds << "ms (" << numbers_file.gigabytes_per_second() << " GB/s)" << std::endl;
+
+    std::vector<int64_t> all_numbers;
+    all_numbers.reserve(numbers_file.number_vectors * numbers_file.size_vectors);
+    for(int64_t i = 0; i < numbers_file.number_vectors; i++){
+        all_numbers.insert(all_numbers.end(), numbers_file.vectors[i].begin(), numbers_file.vectors[i].end());
+    }
+
+    TimeVar t;
+    // Setup, encryption and serialization
+    std::vector<double> processingTimes = {0.0, 0.0};
+
+    TIC(t);
+
+    // Only the public key is needed to encrypt
+    CryptoContext<DCRTPoly> cryptoContext = load_crypto_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+
+    EncryptedDataset dataset(dataset_directory);
+
+    processingTimes[0] = TOC(t);
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+    uint64_t bytes = dataset.append(cryptoContext, publicKey, all_numbers);
+    processingTimes[1] = TOC(t);
+    std::cout << "Duration of encryption and serialization: " << processingTimes[1] << "ms" << std::endl;
+
+    std::cout << "Appended: " << all_numbers.size() << " (" << bytes << " bytes)" << std::endl;
+    std::cout << "Count: " << dataset.count() << std::endl;
+    std::cout << "Generation: " << dataset.getManifest().generation << std::endl;
+
+    // The cached results of the previous generations can never be served again
+    if(!cache_directory.empty()){
+        ResultCache cache(cache_directory);
+        std::cout << "Removed cached results: " << cache.invalidate(dataset) << std::endl;
+    }
+
+    printIntoCSV("append", dataset.getManifest(), processingTimes, bytes);
+
+    return 0;
+}
+
+/*
+ * The keys directory is created by "encryptor keygen" (ClientServer)
+ *
+ * argv[1] --> "init" or "append"
+ *
+ * init:
+ *   argv[2] --> keys directory
+ *   argv[3] --> dataset directory
+ *   argv[4] --> packing (slot or coef)
+ *   argv[5] --> chunk length of the coef packing (optional, ring dimension / 4 by default)
+ *
+ * append:
+ *   argv[2] --> keys directory
+ *   argv[3] --> dataset directory
+ *   argv[4] --> number's file name, with the new values
+ *   argv[5] --> number of threads used to read the file (optional)
+ *   argv[6] --> result cache directory used by "query-dataset", to remove the results this append makes outdated (optional)
+*/
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    try{
+        if(mode == "init" && argc > 4){
+            return init(argv[2], argv[3], argv[4], argc > 5 ? std::stoll(argv[5]) : 0);
+        }
+
+        if(mode == "append" && argc > 4){
+            return append(argv[2], argv[3], argv[4], argc > 5 ? std::stoi(argv[5]) : default_number_threads(), argc > 6 ? argv[6] : "");
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " init <keys directory> <dataset directory> <slot|coef> [chunk length]" << std::endl;
+    std::cerr << "       " << argv[0] << " append <keys directory> <dataset directory> <numbers file> [threads] [cache directory]" << std::endl;
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file query-dataset.cpp
+ * @author Bernardo Ramalho
+ * @brief Evaluates the mean, the variance or the inner product over an encrypted dataset, without encrypting the numbers again
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../includes/encryptedDataset.h"
+#include "../includes/resultCache.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::string statistic, const DatasetManifest& manifest, std::string cache, std::vector<double> processingTimes, double total_time, double value){
+    std::ofstream datasetCSV("timeCSVs/dataset.csv", std::ios_base::app);
+    std::cout.rdbuf(datasetCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\n" << statistic << ", " << manifest.packing << ", " << manifest.generation << ", " << manifest.count() << ", " << cache << ", ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << value << std::endl;
+
+    datasetCSV.close();
+}
+
+/*
+ * The keys directory is created by "encryptor keygen" (ClientServer) and the dataset by "encrypt-dataset"
+ *
+ * argv[1] --> keys directory
+ * argv[2] --> dataset directory
+ * argv[3] --> statistic (mean, variance or inner-product)
+ * argv[4] --> result cache directory, "-" to always evaluate the query (optional)
+ * argv[5] --> second dataset directory, the other vector of the inner product
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 4 || (std::string(argv[3]) == "inner-product" && argc < 6)){
+        std::cerr << "Usage: " << argv[0] << " <keys directory> <dataset directory> <mean|variance> [cache directory|-]" << std::endl;
+        std::cerr << "       " << argv[0] << " <keys directory> <dataset directory> inner-product <cache directory|-> <second dataset directory>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string keys_directory = argv[1];
+    std::string statistic = argv[3];
+    std::string cache_directory = argc > 4 && std::string(argv[4]) != "-" ? argv[4] : "";
+
+    TimeVar t;
+    // Setup, homomorphic operations (including loading the chunks) and decryption
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0};
+
+    try{
+        TIC(t);
+
+        CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+        PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+        PrivateKey<DCRTPoly> secretKey = load_secret_key(keys_directory);
+
+        EncryptedDataset dataset(argv[2]);
+        dataset.checkKeys(cryptoContext, publicKey);
+
+        std::unique_ptr<EncryptedDataset> other;
+        std::string parameters = dataset.getManifest().packing + ":" + std::to_string(dataset.getManifest().chunk_length);
+
+        if(statistic == "inner-product"){
+            other.reset(new EncryptedDataset(argv[5]));
+            other->checkKeys(cryptoContext, publicKey);
+
+            // The result also changes when the second dataset is appended to
+            parameters += ";other=" + other->getManifest().id + ":" + std::to_string(other->getManifest().generation);
+        }
+
+        // The key holds the generation, so results from before the last append never match it
+        std::unique_ptr<ResultCache> cache;
+        std::string cache_key = result_cache_key(dataset, statistic, "none", parameters);
+
+        if(!cache_directory.empty()){
+            cache.reset(new ResultCache(cache_directory));
+        }
+
+        processingTimes[0] = TOC(t);
+        std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+        // Homomorphic Operations
+        // The chunks are deserialized from the mapped parts instead of being encrypted again,
+        // and a query already answered for this generation of the dataset only reads its result
+        TIC(t);
+        Ciphertext<DCRTPoly> result = cache ? cache->lookup(cache_key) : nullptr;
+        bool hit = result != nullptr;
+
+        if(!hit){
+            result = dataset.evaluate(cryptoContext, statistic, other.get());
+
+            if(cache){
+                cache->store(dataset, cache_key, result, other.get());
+            }
+        }
+        processingTimes[1] = TOC(t);
+        std::cout << "Duration of homomorphic operations: " << processingTimes[1] << "ms" << (hit ? " (cached)" : "") << std::endl;
+
+        // Decryption
+        TIC(t);
+        double value = dataset.decryptResult(cryptoContext, secretKey, statistic, result);
+        processingTimes[2] = TOC(t);
+        std::cout << "Duration of decryption: " << processingTimes[2] << "ms" << std::endl;
+
+        // Calculate and print final time and value
+        double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+        std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+        std::cout << "Count: " << dataset.count() << " (generation " << dataset.getManifest().generation << ")" << std::endl;
+        std::cout << statistic << ": " << value << std::endl;
+
+        std::string cache_result = "none";
+        if(cache){
+            // Latency of the query itself: lookup or evaluation, and decryption
+            cache->record(hit, processingTimes[1] + processingTimes[2]);
+            cache_result = hit ? "hit" : "miss";
+
+            const CacheStatistics& statistics = cache->getStatistics();
+            std::cout << "Cache: " << cache_result << std::endl;
+            std::cout << "  Hits: " << statistics.hits << ", misses: " << statistics.misses << " (hit rate " << 100 * statistics.hit_rate() << "%)" << std::endl;
+            std::cout << "  Average latency: " << statistics.average_hit_milliseconds() << "ms on a hit, "
+                      << statistics.average_miss_milliseconds() << "ms on a miss" << std::endl;
+        }
+
+        printIntoCSV(statistic, dataset.getManifest(), cache_result, processingTimes, total_time, value);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
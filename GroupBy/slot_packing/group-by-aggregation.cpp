@@ -0,0 +1,320 @@
+/**
+ * @file group-by-aggregation.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the per group sum and mean (GROUP BY) of n values with public group labels using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <set>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<std::string> rows){
+    std::ofstream groupByCSV("timeCSVs/groupBy.csv", std::ios_base::app);
+    std::cout.rdbuf(groupByCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    for(unsigned int i = 0; i < rows.size(); i++){
+        std::cout << "\n" << rows[i];
+    }
+    std::cout << std::endl;
+
+    groupByCSV.close();
+}
+
+// Smallest power of 2 that fits the groups, each group gets one segment of the row
+int64_t numberSegments(int64_t number_groups){
+    return pow(2, ceil(log2(number_groups)));
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> number of groups, or the maximum number of groups when there is no labels file (optional)
+ * argv[3] --> labels file, with the group (0 to number of groups - 1) of each value (optional)
+ *
+ * Without a labels file, value i goes into group i % number of groups, for 1, 2, 4, ... groups up to the maximum,
+ * to show how the throughput changes with the number of groups
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t max_groups = argc > 2 ? std::stoll(argv[2]) : 16;
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t total_elements = all_numbers.size();
+
+    if(total_elements == 0){
+        std::cerr << "No numbers in the file - '" << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(max_groups < 1){
+        std::cerr << "There must be at least one group" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Group labels are public, only the values are encrypted
+    std::vector<std::vector<int64_t>> runs_labels;
+
+    if(argc > 3){
+        std::ifstream labels_file (argv[3]);
+
+        if (!labels_file.is_open()) {
+            std::cerr << "Could not open the file - '"
+                 << argv[3] << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<int64_t> labels;
+        while (labels_file >> number) {
+            if(number < 0 || number >= max_groups){
+                std::cerr << "Group " << number << " is outside of 0 to " << max_groups - 1 << std::endl;
+                return EXIT_FAILURE;
+            }
+            labels.push_back(number);
+        }
+
+        if((int64_t)labels.size() != total_elements){
+            std::cerr << "The labels file has " << labels.size() << " labels for " << total_elements << " values" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        runs_labels.push_back(labels);
+    }
+    else{
+        for(int64_t groups = 1; groups <= max_groups; groups *= 2){
+            std::vector<int64_t> labels(total_elements);
+            for(int64_t i = 0; i < total_elements; i++){
+                labels[i] = i % groups;
+            }
+            runs_labels.push_back(labels);
+        }
+    }
+
+    TimeVar t;
+
+    TIC(t);
+
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+
+    if(numberSegments(max_groups) > row_size){
+        std::cerr << "At most " << row_size << " groups fit in a row" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Only plaintext multiplications are done, so there is no relinearization key
+    // Generate the rotation evaluation keys of every number of groups that is run: the rotations that fold a row
+    // into one segment and the rotate and sum over one segment
+    std::set<int32_t> rotation_set;
+
+    for(unsigned int run = 0; run < runs_labels.size(); run++){
+        int64_t number_groups = *std::max_element(runs_labels[run].begin(), runs_labels[run].end()) + 1;
+        int64_t segment_width = row_size / numberSegments(number_groups);
+
+        std::vector<int32_t> indexes = generate_rotation_indexes(log2(segment_width));
+        rotation_set.insert(indexes.begin(), indexes.end());
+
+        for(int64_t step = segment_width; step < row_size; step *= 2){
+            rotation_set.insert(step);
+        }
+    }
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, std::vector<int32_t>(rotation_set.begin(), rotation_set.end()));
+
+    // Print time spent on setup
+    TOC(t);
+    double setup_time = TOC(t);
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // The values fill every slot, so the number of ciphertexts does not depend on the number of groups
+    int64_t number_slots = 2 * row_size;
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(int64_t begin = 0; begin < total_elements; begin += number_slots){
+        std::vector<int64_t> numbers(all_numbers.begin() + begin, all_numbers.begin() + std::min(total_elements, begin + number_slots));
+
+        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(numbers);
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    TOC(t);
+    double encryption_time = TOC(t);
+
+    std::cout << "Duration of encryption: " << encryption_time << "ms" << std::endl;
+
+    std::vector<std::string> rows;
+
+    for(unsigned int run = 0; run < runs_labels.size(); run++){
+        const std::vector<int64_t>& labels = runs_labels[run];
+
+        int64_t number_groups = *std::max_element(labels.begin(), labels.end()) + 1;
+        int64_t segment_width = row_size / numberSegments(number_groups);
+        int64_t number_rotations = log2(segment_width);
+
+        // Encryption (shared by every run), homomorphic operations, decryption
+        std::vector<double> processingTimes = {encryption_time, 0.0, 0.0};
+
+        TIC(t);
+
+        // Homomorphic Operations
+        // The one-hot masks of each group are packed in the same way as the values, one mask per group and chunk
+        std::vector<int64_t> counts(number_groups, 0);
+        std::vector<std::vector<std::vector<int64_t>>> group_masks(number_groups, std::vector<std::vector<int64_t>>(ciphertexts.size()));
+
+        for(int64_t i = 0; i < total_elements; i++){
+            std::vector<int64_t>& mask = group_masks[labels[i]][i / number_slots];
+
+            if(mask.empty()){
+                mask.resize(number_slots, 0);
+            }
+
+            mask[i % number_slots] = 1;
+            counts[labels[i]]++;
+        }
+
+        // Every group sum is moved into its own segment of the same accumulator
+        Ciphertext<DCRTPoly> accumulator;
+
+        for(int64_t group = 0; group < number_groups; group++){
+            std::vector<Ciphertext<DCRTPoly>> groupCiphertexts;
+
+            for(unsigned int i = 0; i < ciphertexts.size(); i++){
+                // Chunks without values of the group are skipped
+                if(group_masks[group][i].empty()){
+                    continue;
+                }
+
+                groupCiphertexts.push_back(cryptoContext->EvalMult(ciphertexts[i], cryptoContext->MakePackedPlaintext(group_masks[group][i])));
+            }
+
+            if(groupCiphertexts.empty()){
+                continue;
+            }
+
+            auto groupSum = cryptoContext->EvalAddMany(groupCiphertexts);
+
+            // Fold the row into one segment: after adding the rotations by segment_width, 2*segment_width, ... every
+            // segment holds the same partial sums, whose total is the group sum of the row
+            for(int64_t step = segment_width; step < row_size; step *= 2){
+                groupSum = cryptoContext->EvalAdd(groupSum, cryptoContext->EvalRotate(groupSum, step));
+            }
+
+            // Every segment is the same, so keeping only the segment of the group puts the sum in place without a rotation
+            std::vector<int64_t> segment_mask(number_slots, 0);
+            for(int64_t j = 0; j < segment_width; j++){
+                segment_mask[group * segment_width + j] = 1;
+                segment_mask[row_size + group * segment_width + j] = 1;
+            }
+
+            groupSum = cryptoContext->EvalMult(groupSum, cryptoContext->MakePackedPlaintext(segment_mask));
+
+            accumulator = accumulator ? cryptoContext->EvalAdd(accumulator, groupSum) : groupSum;
+        }
+
+        // One rotate and sum reduces every group at the same time
+        accumulator = rotate_and_sum(cryptoContext, accumulator, number_rotations);
+
+        TOC(t);
+        processingTimes[1] = TOC(t);
+
+        TIC(t);
+
+        // Decryption
+        // All the groups come out of the same decryption
+        Plaintext plaintextDecAdd;
+
+        cryptoContext->Decrypt(keyPair.secretKey, accumulator, &plaintextDecAdd);
+
+        TOC(t);
+        processingTimes[2] = TOC(t);
+
+        // Plaintext Operations
+        std::vector<int64_t> slots = plaintextDecAdd->GetPackedValue();
+        std::vector<int64_t> expected_sums(number_groups, 0);
+        int64_t wrong_results = 0;
+
+        for(int64_t i = 0; i < total_elements; i++){
+            expected_sums[labels[i]] += all_numbers[i];
+        }
+
+        std::cout << "Groups: " << number_groups << " (" << ciphertexts.size() << " ciphertexts)" << std::endl;
+
+        for(int64_t group = 0; group < number_groups; group++){
+            int64_t group_sum = read_segment_sum(slots, group, segment_width, row_size);
+
+            if(group_sum != expected_sums[group]){
+                wrong_results++;
+            }
+
+            if(group < 8){
+                std::cout << "  Group " << group << ": sum " << group_sum << ", mean " << (counts[group] > 0 ? (double)group_sum / counts[group] : 0) << std::endl;
+            }
+        }
+
+        double throughput = total_elements / ((processingTimes[0] + processingTimes[1]) / 1000);
+
+        std::cout << "  Duration of encryption: " << processingTimes[0] << "ms" << std::endl;
+        std::cout << "  Duration of homomorphic operations: " << processingTimes[1] << "ms" << std::endl;
+        std::cout << "  Duration of decryption: " << processingTimes[2] << "ms" << std::endl;
+        std::cout << "  Throughput: " << throughput << " values/s" << std::endl;
+        std::cout << "  Wrong results: " << wrong_results << std::endl;
+
+        rows.push_back(std::to_string(number_groups) + ", " + std::to_string(ciphertexts.size()) + ", " + std::to_string(processingTimes[0]) + ", "
+                       + std::to_string(processingTimes[1]) + ", " + std::to_string(processingTimes[2]) + ", " + std::to_string(throughput) + ", "
+                       + std::to_string(wrong_results));
+    }
+
+    printIntoCSV(rows);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file ckks-inner-product.cpp
+ * @author Bernardo Ramalho
+ * @brief Approximate implementation of the inner product between two real vectors using CKKS
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double innerProduct){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream innerProductCSV("timeCSVs/innerProduct.csv", std::ios_base::app);
+    std::cout.rdbuf(innerProductCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nckks, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << innerProduct << std::endl;
+
+    innerProductCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Body of file is made of two lines, each representing a vector
+    double number;
+    std::vector<std::vector<double>> vectors;
+    std::string vector_line;
+
+    while(std::getline(numbers_file, vector_line)){
+        // Read the line
+        std::istringstream line(vector_line);
+
+        // Read a number at a time from the line and store it in a vector
+        std::vector<double> v;
+        while (line >> number) {
+                v.push_back(number);
+        }
+
+        // Save the vector in a 2D vector
+        vectors.push_back(v);
+    }
+
+    // EvalSum adds together batch_size slots, so the batch has to be 2^x in size
+    int64_t vector_size = vectors[0].size();
+    uint32_t batch_size = (uint32_t)pow(2, ceil(log2(vector_size)));
+
+    // Exact inner product, used to measure the precision of the approximate result
+    long double exact_sum = 0;
+    for(int64_t i = 0; i < vector_size; i++){
+        exact_sum += (long double)vectors[0][i] * vectors[1][i];
+    }
+    double exact_inner_product = exact_sum;
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The multiplication of both vectors is the only operation that consumes a level
+    // One extra level is kept so the final modulus has room for large inner product values
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(40);
+    parameters.SetFirstModSize(60);
+    parameters.SetBatchSize(batch_size);
+    parameters.SetScalingTechnique(FIXEDMANUAL);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation keys used by EvalSum (log2(batch_size) rotations)
+    cryptoContext->EvalSumKeyGen(keyPair.secretKey);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(int i = 0; i < 2; i++){
+        // Encode Plaintext with real slot packing
+        Plaintext plaintext = cryptoContext->MakeCKKSPackedPlaintext(vectors[i]);
+
+        // Encrypt it into a ciphertext vector
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Start by Multiplying both vectors together and bring the scaling factor back down
+    Ciphertext<DCRTPoly> ciphertextResult = cryptoContext->EvalMult(ciphertexts[0], ciphertexts[1]);
+    ciphertextResult = cryptoContext->Rescale(ciphertextResult);
+
+    // EvalSum does the rotate-and-sum ladder, leaving the inner product in every slot
+    ciphertextResult = cryptoContext->EvalSum(ciphertextResult, batch_size);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    Plaintext plaintextDecAdd;
+
+    cryptoContext->Decrypt(keyPair.secretKey, ciphertextResult, &plaintextDecAdd);
+    plaintextDecAdd->SetLength(1);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    // Inner Product value will be in the first element of the plaintext
+    double inner_product = plaintextDecAdd->GetRealPackedValue()[0];
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    // Precision compared with the exact value
+    double absolute_error = std::abs(inner_product - exact_inner_product);
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Inner Product: " << inner_product << std::endl;
+    std::cout << "Exact Inner Product: " << exact_inner_product << std::endl;
+    std::cout << "Absolute error: " << absolute_error << std::endl;
+    std::cout << "Precision: " << -log2(absolute_error) << " bits" << std::endl;
+
+    printIntoCSV(processingTimes, total_time, inner_product);
+
+    return 0;
+}
@@ -14,6 +14,8 @@
 #include <fstream>
 #include <cmath>
 
+#include "../../includes/partialDecryption.h"
+
 using namespace lbcrypto;
 
 void printIntoCSV(std::vector<double> processingTimes, double total_time, double innerProduct){
@@ -161,10 +163,8 @@ int main(int argc, char *argv[]) {
     TIC(t);
 
     // Decryption
-    Plaintext plaintextDecAdd;
-  
-    cryptoContext->Decrypt(keyPair.secretKey, ciphertextResult, &plaintextDecAdd);
-    plaintextDecAdd->SetLength(vector_size);
+    // Inner Product value will be in the last element of the plaintext, so only that coefficient is read
+    int64_t inner_product = decrypt_coefficients(cryptoContext, keyPair.secretKey, ciphertextResult, {(uint32_t)vector_size - 1})[0];
     
     // Print time spent on decryption
     TOC(t);
@@ -172,9 +172,6 @@ int main(int argc, char *argv[]) {
  
     std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
 
-    // Inner Product value will be in the last element of the plaintext
-    int64_t inner_product = plaintextDecAdd->GetCoefPackedValue()[vector_size - 1];
-
     // Calculate and print final time and value
     double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
 
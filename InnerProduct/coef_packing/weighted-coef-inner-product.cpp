@@ -0,0 +1,178 @@
+/**
+ * @file weighted-coef-inner-product.cpp
+ * @author Bernardo Ramalho
+ * @brief Weighted sum and weighted mean of an encrypted vector with public (plaintext) weights using coefficient packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/partialDecryption.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double relin_keygen_time, double ciphertext_mult_time, double innerProduct){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream innerProductCSV("timeCSVs/innerProduct.csv", std::ios_base::app);
+    std::cout.rdbuf(innerProductCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nweighted-coef, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << innerProduct << ", " << relin_keygen_time << ", " << ciphertext_mult_time << std::endl;
+
+    innerProductCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name, the first line is the vector of values and the second one the public weights
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Body of file is made of two lines, each representing a vector
+    int64_t number;
+    std::vector<std::vector<int64_t>> vectors;
+    std::string vector_line;
+
+    while(std::getline(numbers_file, vector_line)){
+        // Read the line
+        std::istringstream line(vector_line);
+
+        // Read a number at a time from the line and store it in a vector
+        std::vector<int64_t> v;
+        while (line >> number) {
+                v.push_back(number);
+        }
+
+        // Save the vector in a 2D vector
+        vectors.push_back(v);
+    }
+
+    // The weights are public, so their sum is calculated in the clear
+    int64_t weight_sum = std::accumulate(vectors[1].begin(), vectors[1].end(), (int64_t)0);
+    int64_t vector_size = vectors[0].size();
+
+    // By reversing the weights, the weighted sum will be at the last index of the vector size after the multiplication
+    reverse(vectors[1].begin(), vectors[1].end());
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(65537);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // The weights are multiplied as a plaintext, so no relinearization key is needed
+
+    // Encode the weights only once
+    Plaintext weightsPlaintext = cryptoContext->MakeCoefPackedPlaintext(vectors[1]);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Only the values are encrypted
+    Plaintext plaintext = cryptoContext->MakeCoefPackedPlaintext(vectors[0]);
+    Ciphertext<DCRTPoly> ciphertext = cryptoContext->Encrypt(keyPair.publicKey, plaintext);
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Multiplying by the reversed weights calculates the weighted sum on the last index of the vector
+    Ciphertext<DCRTPoly> ciphertextResult = cryptoContext->EvalMult(ciphertext, weightsPlaintext);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // Only the coefficient with the weighted sum is read
+    int64_t weighted_sum = decrypt_coefficients(cryptoContext, keyPair.secretKey, ciphertextResult, {(uint32_t)vector_size - 1})[0];
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    double weighted_mean = weight_sum != 0 ? (double)weighted_sum / weight_sum : 0;
+
+    // Same product with encrypted weights, as in coef-inner-product.cpp, to compare both paths
+    TIC(t);
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+    double relin_keygen_time = TOC(t);
+
+    Ciphertext<DCRTPoly> weightsCiphertext = cryptoContext->Encrypt(keyPair.publicKey, weightsPlaintext);
+
+    TIC(t);
+    Ciphertext<DCRTPoly> ciphertextProduct = cryptoContext->EvalMult(ciphertext, weightsCiphertext);
+    double ciphertext_mult_time = TOC(t);
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Weighted sum: " << weighted_sum << std::endl;
+    std::cout << "Weighted mean: " << weighted_mean << std::endl;
+    std::cout << "Relinearization key generation (not needed): " << relin_keygen_time << "ms" << std::endl;
+    std::cout << "Homomorphic operations with encrypted weights: " << ciphertext_mult_time << "ms" << std::endl;
+
+    printIntoCSV(processingTimes, total_time, relin_keygen_time, ciphertext_mult_time, weighted_sum);
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+/**
+ * @file matrix-vector-product.cpp
+ * @author Bernardo Ramalho
+ * @brief Product between a matrix and an encrypted vector (one inner product per row) using the diagonal method and Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+// Each row: approach, setup, encryption, homomorphic operations, decryption, total, homomorphic time per output element, wrong results
+void printIntoCSV(std::vector<std::string> rows){
+    std::ofstream matrixCSV("timeCSVs/matrixVector.csv", std::ios_base::app);
+    std::cout.rdbuf(matrixCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    for(unsigned int i = 0; i < rows.size(); i++){
+        std::cout << "\n" << rows[i];
+    }
+    std::cout << std::endl;
+
+    matrixCSV.close();
+}
+
+// Repeat the values with the given period over the first row, the second row is left empty
+std::vector<int64_t> replicate(const std::vector<int64_t>& values, int64_t period, int64_t row_size){
+    std::vector<int64_t> slots(2 * row_size, 0);
+
+    for(int64_t slot = 0; slot < row_size; slot++){
+        slots[slot] = values[slot % period];
+    }
+
+    return slots;
+}
+
+/*
+ * Diagonal k of the (dimension x dimension) matrix: diagonal_k[i] = M[i][(i + k) % dimension]
+ * For the baby-step giant-step, diagonal j * baby + i is rotated right by j * baby in advance, so the giant step
+ * rotation of the inner sum puts it back in place
+*/
+std::vector<std::vector<int64_t>> bsgsDiagonals(const std::vector<std::vector<int64_t>>& matrix, int64_t dimension, int64_t baby, int64_t row_size){
+    std::vector<std::vector<int64_t>> diagonals;
+
+    for(int64_t k = 0; k < dimension; k++){
+        int64_t giant_shift = (k / baby) * baby;
+        std::vector<int64_t> diagonal(dimension);
+
+        for(int64_t i = 0; i < dimension; i++){
+            // Slot i holds diagonal_k[i - giant_shift]
+            int64_t row = ((i - giant_shift) % dimension + dimension) % dimension;
+            diagonal[i] = matrix[row][(row + k) % dimension];
+        }
+
+        diagonals.push_back(replicate(diagonal, dimension, row_size));
+    }
+
+    return diagonals;
+}
+
+// Rotations of the vector by 0 to baby - 1, hoisted: the expensive decomposition of the ciphertext is done only once
+std::vector<Ciphertext<DCRTPoly>> babySteps(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t baby){
+    std::vector<Ciphertext<DCRTPoly>> rotations = {ciphertext};
+
+    auto precomputed = cryptoContext->EvalFastRotationPrecompute(ciphertext);
+    uint32_t cyclotomic_order = 2 * cryptoContext->GetRingDimension();
+
+    for(int64_t i = 1; i < baby; i++){
+        rotations.push_back(cryptoContext->EvalFastRotation(ciphertext, i, cyclotomic_order, precomputed));
+    }
+
+    return rotations;
+}
+
+// Plaintext matrix: sum over the giant steps j of rotate(sum over the baby steps i of diagonal_{j*baby+i} * rotate(v, i), j*baby)
+Ciphertext<DCRTPoly> plaintextMatrixProduct(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& rotations,
+                                            const std::vector<Plaintext>& diagonals, int64_t baby){
+    Ciphertext<DCRTPoly> result;
+
+    for(size_t giant = 0; giant * baby < diagonals.size(); giant++){
+        std::vector<Ciphertext<DCRTPoly>> products;
+
+        for(int64_t i = 0; i < baby; i++){
+            products.push_back(cryptoContext->EvalMult(rotations[i], diagonals[giant * baby + i]));
+        }
+
+        auto innerSum = cryptoContext->EvalAddMany(products);
+
+        if(giant > 0){
+            innerSum = cryptoContext->EvalRotate(innerSum, giant * baby);
+        }
+
+        result = result ? cryptoContext->EvalAdd(result, innerSum) : innerSum;
+    }
+
+    return result;
+}
+
+// Encrypted matrix: same as above, each inner sum is only relinearized once, before its giant step rotation
+Ciphertext<DCRTPoly> encryptedMatrixProduct(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& rotations,
+                                            const std::vector<Ciphertext<DCRTPoly>>& diagonals, int64_t baby){
+    Ciphertext<DCRTPoly> result;
+
+    for(size_t giant = 0; giant * baby < diagonals.size(); giant++){
+        std::vector<Ciphertext<DCRTPoly>> products;
+
+        for(int64_t i = 0; i < baby; i++){
+            products.push_back(cryptoContext->EvalMultNoRelin(rotations[i], diagonals[giant * baby + i]));
+        }
+
+        auto innerSum = cryptoContext->Relinearize(cryptoContext->EvalAddMany(products));
+
+        if(giant > 0){
+            innerSum = cryptoContext->EvalRotate(innerSum, giant * baby);
+        }
+
+        result = result ? cryptoContext->EvalAdd(result, innerSum) : innerSum;
+    }
+
+    return result;
+}
+
+/*
+ * argv[1] --> number's file name, the first line is the vector and every other line is a row of the matrix
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Body of file is made of lines, each representing a vector
+    int64_t number;
+    std::vector<std::vector<int64_t>> vectors;
+    std::string vector_line;
+
+    while(std::getline(numbers_file, vector_line)){
+        // Read the line
+        std::istringstream line(vector_line);
+
+        // Read a number at a time from the line and store it in a vector
+        std::vector<int64_t> v;
+        while (line >> number) {
+                v.push_back(number);
+        }
+
+        if(!v.empty()){
+            vectors.push_back(v);
+        }
+    }
+
+    std::vector<int64_t> input_vector = vectors[0];
+    std::vector<std::vector<int64_t>> matrix(vectors.begin() + 1, vectors.end());
+
+    int64_t number_rows = matrix.size();
+    int64_t number_columns = input_vector.size();
+
+    // The diagonal method works on a square matrix, so the matrix is padded with zeros to a 2^x square
+    int64_t dimension = pow(2, ceil(log2(std::max(number_rows, number_columns))));
+
+    input_vector.resize(dimension, 0);
+    matrix.resize(dimension, std::vector<int64_t>(dimension, 0));
+    for(int64_t row = 0; row < dimension; row++){
+        matrix[row].resize(dimension, 0);
+    }
+
+    // Baby-step giant-step: dimension = baby * giant, with baby rotations hoisted and giant - 1 rotations of the inner sums
+    int64_t baby = pow(2, ceil(log2(dimension) / 2));
+    int64_t giant = dimension / baby;
+
+    TimeVar t;
+
+    TIC(t);
+
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+
+    if(dimension > row_size){
+        std::cerr << "The matrix has to fit in a row of " << row_size << " slots" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key, only used with the encrypted matrix
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys of the baby and giant steps, and of the rotate and sum of the row by row approach
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(log2(dimension));
+    for(int64_t i = 1; i < baby; i++){
+        rotation_indexes.push_back(i);
+    }
+    for(int64_t j = 1; j < giant; j++){
+        rotation_indexes.push_back(j * baby);
+    }
+    std::sort(rotation_indexes.begin(), rotation_indexes.end());
+    rotation_indexes.erase(std::unique(rotation_indexes.begin(), rotation_indexes.end()), rotation_indexes.end());
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Encode the diagonals of the matrix
+    std::vector<std::vector<int64_t>> diagonals = bsgsDiagonals(matrix, dimension, baby, row_size);
+    std::vector<Plaintext> diagonalPlaintexts;
+
+    for(int64_t k = 0; k < dimension; k++){
+        diagonalPlaintexts.push_back(cryptoContext->MakePackedPlaintext(diagonals[k]));
+    }
+
+    // Print time spent on setup
+    TOC(t);
+    double setup_time = TOC(t);
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+    std::cout << "Matrix: " << number_rows << "x" << number_columns << " (padded to " << dimension << "x" << dimension
+              << ", " << baby << " baby steps and " << giant << " giant steps)" << std::endl;
+
+    // Expected result, calculated in the clear
+    std::vector<int64_t> expected(number_rows, 0);
+    for(int64_t row = 0; row < number_rows; row++){
+        for(int64_t column = 0; column < number_columns; column++){
+            expected[row] += matrix[row][column] * input_vector[column];
+        }
+    }
+
+    // The vector is replicated along the row so every rotation wraps around with the period of the matrix
+    TIC(t);
+    Ciphertext<DCRTPoly> vectorCiphertext = cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakePackedPlaintext(replicate(input_vector, dimension, row_size)));
+    double vector_encryption_time = TOC(t);
+
+    // Encrypted matrix: each diagonal is encrypted on its own
+    TIC(t);
+    std::vector<Ciphertext<DCRTPoly>> diagonalCiphertexts;
+    for(int64_t k = 0; k < dimension; k++){
+        diagonalCiphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, diagonalPlaintexts[k]));
+    }
+    double matrix_encryption_time = TOC(t);
+
+    std::vector<std::string> approaches = {"diagonal-plaintext", "diagonal-encrypted", "row-by-row"};
+    std::vector<std::string> rows;
+
+    for(size_t a = 0; a < approaches.size(); a++){
+        // Setup, encryption, homomorphic operations, decryption
+        std::vector<double> processingTimes = {setup_time, vector_encryption_time, 0.0, 0.0};
+        std::vector<Ciphertext<DCRTPoly>> resultCiphertexts;
+
+        if(approaches[a] == "diagonal-encrypted"){
+            processingTimes[1] += matrix_encryption_time;
+        }
+
+        TIC(t);
+
+        // Homomorphic Operations
+        if(approaches[a] == "row-by-row"){
+            // One inner product per row, as running optimized-inner-product.cpp for each row
+            for(int64_t row = 0; row < number_rows; row++){
+                auto product = cryptoContext->EvalMult(vectorCiphertext, cryptoContext->MakePackedPlaintext(matrix[row]));
+
+                resultCiphertexts.push_back(rotate_and_sum(cryptoContext, product, log2(dimension)));
+            }
+        }
+        else{
+            std::vector<Ciphertext<DCRTPoly>> rotations = babySteps(cryptoContext, vectorCiphertext, baby);
+
+            if(approaches[a] == "diagonal-plaintext"){
+                resultCiphertexts.push_back(plaintextMatrixProduct(cryptoContext, rotations, diagonalPlaintexts, baby));
+            }
+            else{
+                resultCiphertexts.push_back(encryptedMatrixProduct(cryptoContext, rotations, diagonalCiphertexts, baby));
+            }
+        }
+
+        TOC(t);
+        processingTimes[2] = TOC(t);
+
+        TIC(t);
+
+        // Decryption
+        // With the diagonal method every output element comes out of the same decryption, row i in slot i.
+        // Row by row, each row has its own ciphertext with the result in the first slot
+        std::vector<int64_t> result;
+
+        for(size_t i = 0; i < resultCiphertexts.size(); i++){
+            Plaintext plaintextResult;
+            cryptoContext->Decrypt(keyPair.secretKey, resultCiphertexts[i], &plaintextResult);
+
+            const std::vector<int64_t>& slots = plaintextResult->GetPackedValue();
+
+            if(resultCiphertexts.size() == 1){
+                result.assign(slots.begin(), slots.begin() + number_rows);
+            }
+            else{
+                result.push_back(slots[0]);
+            }
+        }
+
+        TOC(t);
+        processingTimes[3] = TOC(t);
+
+        int64_t wrong_results = 0;
+        for(int64_t row = 0; row < number_rows; row++){
+            wrong_results += result[row] != expected[row];
+        }
+
+        double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+        std::cout << approaches[a] << ": homomorphic operations " << processingTimes[2] << "ms (" << processingTimes[2] / number_rows
+                  << "ms per output element), decryption " << processingTimes[3] << "ms, wrong results " << wrong_results << std::endl;
+
+        std::string csv_row = approaches[a] + ", ";
+        for(unsigned int i = 0; i < processingTimes.size(); i++){
+            csv_row += std::to_string(processingTimes[i]) + ", ";
+        }
+        csv_row += std::to_string(total_time) + ", " + std::to_string(processingTimes[2] / number_rows) + ", " + std::to_string(wrong_results);
+
+        rows.push_back(csv_row);
+    }
+
+    printIntoCSV(rows);
+
+    return 0;
+}
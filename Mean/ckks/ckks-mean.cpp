@@ -0,0 +1,194 @@
+/**
+ * @file ckks-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief Approximate FHE implementation of the mean of n real values using CKKS
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/mean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nckks, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << mean << std::endl;
+
+    meanCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors;
+    double number;
+    std::vector<double> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    int64_t total_elements = size_vectors * number_vectors;
+
+    // Body of the file contains all the numbers, which can now be real values
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    // EvalSum adds together batch_size slots, so the batch has to be 2^x in size
+    uint32_t batch_size = (uint32_t)pow(2, ceil(log2(size_vectors)));
+
+    // Exact mean, used to measure the precision of the approximate result
+    long double exact_sum = 0;
+    for(int64_t i = 0; i < total_elements; i++){
+        exact_sum += all_numbers[i];
+    }
+    double exact_mean = exact_sum / total_elements;
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // Only the division by n consumes a level, everything else are additions and rotations
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetScalingModSize(40);
+    parameters.SetFirstModSize(60);
+    parameters.SetBatchSize(batch_size);
+    parameters.SetScalingTechnique(FIXEDMANUAL);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the rotation keys used by EvalSum (log2(batch_size) rotations)
+    cryptoContext->EvalSumKeyGen(keyPair.secretKey);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    int begin, end;
+
+    for(int i = 0; i < number_vectors; i++){
+        // Calculate beginning and end of plaintext values
+        begin = i * size_vectors;
+        end = size_vectors * (i + 1);
+
+        // Encode Plaintext with real slot packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakeCKKSPackedPlaintext(std::vector<double>(all_numbers.begin() + begin, all_numbers.begin() + end));
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    auto ciphertextAdd = cryptoContext->EvalAddMany(ciphertexts);
+
+    // EvalSum does the rotate-and-sum ladder, leaving the total in every slot
+    auto ciphertextSum = cryptoContext->EvalSum(ciphertextAdd, batch_size);
+
+    // Divide by n homomorphically and rescale back to the original scaling factor
+    auto ciphertextMean = cryptoContext->EvalMult(ciphertextSum, 1.0 / total_elements);
+    ciphertextMean = cryptoContext->Rescale(ciphertextMean);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    Plaintext plaintextDecMean;
+
+    cryptoContext->Decrypt(keyPair.secretKey, ciphertextMean, &plaintextDecMean);
+    plaintextDecMean->SetLength(1);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // The division was already done homomorphically, so the mean is just the first slot
+    double mean = plaintextDecMean->GetRealPackedValue()[0];
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    // Precision compared with the exact value
+    double absolute_error = std::abs(mean - exact_mean);
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Mean: " << mean << std::endl;
+    std::cout << "Exact mean: " << exact_mean << std::endl;
+    std::cout << "Absolute error: " << absolute_error << std::endl;
+    std::cout << "Precision: " << -log2(absolute_error) << " bits" << std::endl;
+
+    printIntoCSV(processingTimes, total_time, mean);
+}
@@ -0,0 +1,208 @@
+/**
+ * @file filtered-coef-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the mean of the values selected by a public predicate (a range of positions) using Coefficient Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../../includes/partialDecryption.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/mean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nfiltered-coef, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << mean << std::endl;
+
+    meanCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> first position selected by the predicate
+ * argv[3] --> last position selected by the predicate
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t total_elements = all_numbers.size();
+
+    // The predicate is public: it only depends on the position of the value (e.g. a date range), not on the value itself
+    int64_t first = argc > 2 ? std::stoll(argv[2]) : 0;
+    int64_t last = argc > 3 ? std::stoll(argv[3]) : total_elements - 1;
+
+    std::vector<int64_t> mask(total_elements, 0);
+    for(int64_t i = std::max<int64_t>(first, 0); i <= last && i < total_elements; i++){
+        mask[i] = 1;
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each chunk uses half of the coefficients: the product with the reversed mask fills coefficients 0 to 2 * chunk_size - 2,
+    // so the last coefficient is free for the count
+    uint32_t ring_dimension = cryptoContext->GetRingDimension();
+    int64_t chunk_size = ring_dimension / 2;
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Only plaintext multiplications are done, so there is no relinearization key and no rotation is needed
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(int64_t begin = 0; begin < total_elements; begin += chunk_size){
+        int64_t end = std::min(begin + chunk_size, total_elements);
+
+        // Encode Plaintext with coefficient packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakeCoefPackedPlaintext(std::vector<int64_t>(all_numbers.begin() + begin, all_numbers.begin() + end));
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Like the inner product, multiplying by the reversed mask leaves sum(x * mask) of the chunk in coefficient chunk_size - 1
+    std::vector<Ciphertext<DCRTPoly>> filteredCiphertexts;
+    int64_t count = 0;
+
+    for(unsigned int i = 0; i < ciphertexts.size(); i++){
+        std::vector<int64_t> reversed_mask(chunk_size, 0);
+        int64_t selected = 0;
+
+        for(int64_t j = 0; j < chunk_size && i * chunk_size + j < total_elements; j++){
+            reversed_mask[chunk_size - 1 - j] = mask[i * chunk_size + j];
+            selected += mask[i * chunk_size + j];
+        }
+
+        // Chunks with nothing selected are skipped
+        if(selected == 0){
+            continue;
+        }
+
+        filteredCiphertexts.push_back(cryptoContext->EvalMult(ciphertexts[i], cryptoContext->MakeCoefPackedPlaintext(reversed_mask)));
+        count += selected;
+    }
+
+    // The count goes into the last coefficient, so it comes out of the same decryption
+    std::vector<int64_t> count_coefficients(ring_dimension, 0);
+    count_coefficients[ring_dimension - 1] = count;
+    Plaintext countPlaintext = cryptoContext->MakeCoefPackedPlaintext(count_coefficients);
+
+    auto ciphertextAdd = filteredCiphertexts.empty() ? cryptoContext->Encrypt(keyPair.publicKey, countPlaintext)
+                                                     : cryptoContext->EvalAdd(cryptoContext->EvalAddMany(filteredCiphertexts), countPlaintext);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // Only the coefficients with the sum and the count are read
+    std::vector<int64_t> values = decrypt_coefficients(cryptoContext, keyPair.secretKey, ciphertextAdd, {(uint32_t)chunk_size - 1, ring_dimension - 1});
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    int64_t filtered_sum = values[0];
+    int64_t decrypted_count = values[1];
+
+    double mean = decrypted_count > 0 ? (double)filtered_sum / decrypted_count : 0;
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Filtered sum: " << filtered_sum << std::endl;
+    std::cout << "Count: " << decrypted_count << std::endl;
+    std::cout << "Mean: " << mean << std::endl;
+
+    printIntoCSV(processingTimes, total_time, mean);
+}
@@ -13,6 +13,8 @@
 #include <iostream>
 #include <fstream>
 
+#include "../../includes/partialDecryption.h"
+
 using namespace lbcrypto;
 
 void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean){
@@ -157,9 +159,10 @@ int main(int argc, char *argv[]) {
     TIC(t);
 
     // Decryption
-    Plaintext plaintextDecAdd;
- 
-    cryptoContext->Decrypt(keyPair.secretKey, ciphertextAdd, &plaintextDecAdd);
+    // Only the first and the last coefficients hold the sum, so only those two are read
+    uint32_t numberValues = cryptoContext->GetRingDimension();
+
+    std::vector<int64_t> sumValues = decrypt_coefficients(cryptoContext, keyPair.secretKey, ciphertextAdd, {0, numberValues - 1});
 
     // Print time spent on decryption
     TOC(t);
@@ -170,9 +173,7 @@ int main(int argc, char *argv[]) {
     TIC(t);
 
     // Plaintext Operations
-    int numberValues = plaintextDecAdd->GetCoefPackedValue().size();
-    
-    double mean_sum = plaintextDecAdd->GetCoefPackedValue()[0]*-1 + plaintextDecAdd->GetCoefPackedValue()[numberValues - 1];
+    double mean_sum = sumValues[0]*-1 + sumValues[1];
    
     double mean = mean_sum / total_elements; 
 
@@ -0,0 +1,225 @@
+/**
+ * @file filtered-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the mean of the values selected by a public predicate (a range of positions) using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/mean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nfiltered, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << mean << std::endl;
+
+    meanCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> first position selected by the predicate
+ * argv[3] --> last position selected by the predicate
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t total_elements = all_numbers.size();
+
+    // The predicate is public: it only depends on the position of the value (e.g. a date range), not on the value itself
+    int64_t first = argc > 2 ? std::stoll(argv[2]) : 0;
+    int64_t last = argc > 3 ? std::stoll(argv[3]) : total_elements - 1;
+
+    std::vector<int64_t> mask(total_elements, 0);
+    for(int64_t i = std::max<int64_t>(first, 0); i <= last && i < total_elements; i++){
+        mask[i] = 1;
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each row is split in two segments: the filtered sum ends in the first one and the count in the second one
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t segment_width = row_size / 2;
+
+    // The rotate and sum only has to cover one segment
+    int64_t number_rotations = log2(segment_width);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Only plaintext multiplications are done, so there is no relinearization key
+    // Generate the rotation evaluation keys
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, generate_rotation_indexes(number_rotations));
+
+    // The masks are packed in the same way as the values, so each mask slot lines up with its value
+    std::vector<std::vector<int64_t>> packed_masks = pack_first_segment(mask, segment_width, row_size);
+
+    // The masks of all chunks added together and moved into the second segment, so the rotate and sum also counts the selected values
+    std::vector<int64_t> count_slots(2 * row_size, 0);
+    for(unsigned int i = 0; i < packed_masks.size(); i++){
+        for(int64_t slot = 0; slot < 2 * row_size; slot++){
+            if(packed_masks[i][slot]){
+                count_slots[slot + segment_width]++;
+            }
+        }
+    }
+    Plaintext countPlaintext = cryptoContext->MakePackedPlaintext(count_slots);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+    std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(all_numbers, segment_width, row_size);
+
+    for(unsigned int i = 0; i < packed_numbers.size(); i++){
+        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Multiply each chunk by its mask. Chunks with nothing selected are skipped and chunks with everything selected are not multiplied
+    std::vector<Ciphertext<DCRTPoly>> filteredCiphertexts;
+
+    for(unsigned int i = 0; i < ciphertexts.size(); i++){
+        int64_t selected = std::count(packed_masks[i].begin(), packed_masks[i].end(), 1);
+        int64_t chunk_values = std::min(2 * segment_width, total_elements - (int64_t)i * 2 * segment_width);
+
+        if(selected == 0){
+            continue;
+        }
+
+        if(selected == chunk_values){
+            filteredCiphertexts.push_back(ciphertexts[i]);
+        }
+        else{
+            filteredCiphertexts.push_back(cryptoContext->EvalMult(ciphertexts[i], cryptoContext->MakePackedPlaintext(packed_masks[i])));
+        }
+    }
+
+    // Add the count into the second segment and reduce both segments at the same time
+    auto ciphertextAdd = filteredCiphertexts.empty() ? cryptoContext->Encrypt(keyPair.publicKey, countPlaintext)
+                                                     : cryptoContext->EvalAdd(cryptoContext->EvalAddMany(filteredCiphertexts), countPlaintext);
+
+    ciphertextAdd = rotate_and_sum(cryptoContext, ciphertextAdd, number_rotations);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // The sum and the count come out of the same decryption
+    Plaintext plaintextDecAdd;
+
+    cryptoContext->Decrypt(keyPair.secretKey, ciphertextAdd, &plaintextDecAdd);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    std::vector<int64_t> slots = plaintextDecAdd->GetPackedValue();
+
+    int64_t filtered_sum = read_segment_sum(slots, 0, segment_width, row_size);
+    int64_t count = read_segment_sum(slots, 1, segment_width, row_size);
+
+    double mean = count > 0 ? (double)filtered_sum / count : 0;
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Filtered sum: " << filtered_sum << std::endl;
+    std::cout << "Count: " << count << std::endl;
+    std::cout << "Mean: " << mean << std::endl;
+
+    printIntoCSV(processingTimes, total_time, mean);
+}
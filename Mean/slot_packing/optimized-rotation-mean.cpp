@@ -13,6 +13,10 @@
 #include <iostream>
 #include <fstream>
 
+#include "../../includes/checkpoint.h"
+#include "../../includes/numberFileLoader.h"
+#include "../../includes/threadPool.h"
+
 using namespace lbcrypto;
 
 void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean){
@@ -36,30 +40,40 @@ void printIntoCSV(std::vector<double> processingTimes, double total_time, double
 
 /*
  * argv[1] --> number's file name
+ * argv[2] --> number of threads used to read the file (optional)
+ * argv[3] --> checkpoint directory (optional)
+ * argv[4] --> number of chunks between checkpoints (optional)
+ * argv[5] --> "resume" to continue from the last checkpoint in the directory (optional)
 */
 int main(int argc, char *argv[]) {
-    // Read the vector from a file
-    std::ifstream numbers_file (argv[1]);
+    unsigned int number_threads = argc > 2 ? std::stoi(argv[2]) : default_number_threads();
+    std::string checkpoint_directory = argc > 3 ? argv[3] : "";
+    int64_t checkpoint_interval = argc > 4 ? std::stoll(argv[4]) : 100;
+    bool resume = argc > 5 && std::string(argv[5]) == "resume";
 
-     if (!numbers_file.is_open()) {
-        std::cerr << "Could not open the file - '"
-             << argv[1] << "'" << std::endl;
+    if(checkpoint_interval <= 0){
+        std::cerr << "The number of chunks between checkpoints must be positive" << std::endl;
         return EXIT_FAILURE;
     }
 
+    // Read the vectors from the file
     // Header of file contains information about nr of vector and the size of each of them
-    int64_t number_vectors, size_vectors, number;
-    std::vector<int64_t> all_numbers;
+    NumberFile numbers_file;
+
+    try{
+        numbers_file = load_number_file(argv[1], number_threads);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    numbers_file >> number_vectors;
-    numbers_file >> size_vectors;
+    int64_t number_vectors = numbers_file.number_vectors;
+    int64_t size_vectors = numbers_file.size_vectors;
 
     int64_t total_elements = size_vectors * number_vectors;
 
-    // Body of the file contains all the numbers
-    while (numbers_file >> number) {
-        all_numbers.push_back(number);
-    }
+    std::cout << "Duration of reading: " << numbers_file.milliseconds << "ms (" << numbers_file.gigabytes_per_second() << " GB/s)" << std::endl;
 
     // Due to the optimization we can do log(n) - 1 rotations
     double number_rotations = ceil(log2(size_vectors)) - 1;
@@ -69,37 +83,68 @@ int main(int argc, char *argv[]) {
 
     TIC(t);
 
-    // Set CryptoContext
-    CCParams<CryptoContextBFVRNS> parameters;
-    parameters.SetPlaintextModulus(65537);
-    parameters.SetMultiplicativeDepth(2);
-
-    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
-    // Enable features that you wish to use
-    cryptoContext->Enable(PKE);
-    cryptoContext->Enable(KEYSWITCH);
-    cryptoContext->Enable(LEVELEDSHE);
-    cryptoContext->Enable(ADVANCEDSHE);
-
-    // Key Generation
-
-    // Initialize Public Key Containers
+    CryptoContext<DCRTPoly> cryptoContext;
     KeyPair<DCRTPoly> keyPair;
-
-    // Generate a public/private key pair
-    keyPair = cryptoContext->KeyGen();
-
-    // Generate the relinearization key
-    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+    CheckpointState checkpoint;
+    std::string checkpoint_input_id = checkpoint_directory.empty() ? "" : checkpoint_input(argv[1]);
+
+    if(resume){
+        // The accumulator of the checkpoint is encrypted under its keys, so they are loaded instead of generated
+        try{
+            cryptoContext = load_evaluation_context(checkpoint_directory);
+            keyPair.publicKey = load_public_key(checkpoint_directory);
+            keyPair.secretKey = load_secret_key(checkpoint_directory);
+
+            checkpoint = load_checkpoint(checkpoint_directory, cryptoContext, keyPair.publicKey, "optimized-rotation-mean", checkpoint_input_id, 1);
+        }
+        catch(const std::exception& e){
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "Resuming from chunk " << checkpoint.next_chunk << " of " << number_vectors << std::endl;
+    }
+    else{
+        // Set CryptoContext
+        CCParams<CryptoContextBFVRNS> parameters;
+        parameters.SetPlaintextModulus(65537);
+        parameters.SetMultiplicativeDepth(2);
+
+        cryptoContext = GenCryptoContext(parameters);
+        // Enable features that you wish to use
+        cryptoContext->Enable(PKE);
+        cryptoContext->Enable(KEYSWITCH);
+        cryptoContext->Enable(LEVELEDSHE);
+        cryptoContext->Enable(ADVANCEDSHE);
+
+        // Key Generation
+
+        // Generate a public/private key pair
+        keyPair = cryptoContext->KeyGen();
+
+        // Generate the relinearization key
+        cryptoContext->EvalMultKeyGen(keyPair.secretKey);
     
-    // Generate the rotation evaluation keys
-    std::vector<int32_t> rotation_indexes;
-    for(int i = 0; i < number_rotations; i++){
-       rotation_indexes.push_back(pow(2,i)); // Rotate always in 2^i
+        // Generate the rotation evaluation keys
+        std::vector<int32_t> rotation_indexes;
+        for(int i = 0; i < number_rotations; i++){
+           rotation_indexes.push_back(pow(2,i)); // Rotate always in 2^i
+        }
+
+        cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+        // An unwritable checkpoint directory is reported before any work is done, like a failed resume
+        if(!checkpoint_directory.empty()){
+            try{
+                start_checkpoints(checkpoint_directory, cryptoContext, keyPair);
+            }
+            catch(const std::exception& e){
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
     }
 
-    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);    
-    
     // Print time spent on setup
     TOC(t);
     processingTimes[0] = TOC(t);
@@ -111,18 +156,51 @@ int main(int argc, char *argv[]) {
     // Create Plaintexts
     std::vector<Ciphertext<DCRTPoly>> ciphertexts;
     
-    int begin, end;
-    
-    for(int i = 0; i < number_vectors; i++){
-        // Calculate beginning and end of plaintext values
-        begin = i * size_vectors;
-        end = size_vectors * (i + 1);
-
-        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
-        Plaintext plaintext = cryptoContext->MakePackedPlaintext(std::vector<int64_t>(all_numbers.begin() + begin, all_numbers.begin() + end));
-        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    if(checkpoint_directory.empty()){
+        for(int i = 0; i < number_vectors; i++){
+            // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(numbers_file.vectors[i]);
+            ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+        }
     }
-    
+    else{
+        // Each chunk is added into the accumulator as soon as it is encrypted, so the accumulator and the number
+        // of chunks done are all that is needed to continue. They are saved every checkpoint_interval chunks
+        Ciphertext<DCRTPoly> accumulator = checkpoint.accumulators.empty() ? nullptr : checkpoint.accumulators[0];
+        double checkpoint_time = 0;
+        int number_checkpoints = 0;
+
+        for(int64_t i = checkpoint.next_chunk; i < number_vectors; i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(numbers_file.vectors[i]);
+            Ciphertext<DCRTPoly> ciphertext = cryptoContext->Encrypt(keyPair.publicKey, plaintext);
+
+            accumulator = accumulator ? cryptoContext->EvalAdd(accumulator, ciphertext) : ciphertext;
+
+            if((i + 1) % checkpoint_interval == 0 && i + 1 < number_vectors){
+                TimeVar checkpoint_timer;
+                TIC(checkpoint_timer);
+
+                checkpoint.next_chunk = i + 1;
+                checkpoint.accumulators = {accumulator};
+
+                // A failed checkpoint only means a later crash restarts from an older one
+                try{
+                    save_checkpoint(checkpoint_directory, cryptoContext, keyPair.publicKey, "optimized-rotation-mean", checkpoint_input_id, checkpoint);
+                    number_checkpoints++;
+                }
+                catch(const std::exception& e){
+                    std::cerr << "Checkpoint failed: " << e.what() << std::endl;
+                }
+
+                checkpoint_time += TOC(checkpoint_timer);
+            }
+        }
+
+        std::cout << "Checkpoints: " << number_checkpoints << " (" << checkpoint_time << "ms)" << std::endl;
+
+        ciphertexts.push_back(accumulator);
+    }
+
     // Print time spent on encryption
     TOC(t);
     processingTimes[1] = TOC(t);
@@ -0,0 +1,247 @@
+/**
+ * @file pipelined-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the mean of n values using Slot Packing, with parsing, encoding, encryption and accumulation pipelined
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+
+#include "../../includes/auxiliaryFunctions.h"
+#include "../../includes/numberFileLoader.h"
+#include "../../includes/pipeline.h"
+#include "../../includes/threadPool.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean, const Pipeline& pipeline, double pipeline_time){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/mean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\npipelined, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << mean << std::endl;
+
+    meanCSV.close();
+
+    // One row per stage: name, threads, items, busy, input stall and output stall (ms), average input queue size, pipeline time
+    std::ofstream pipelineCSV("timeCSVs/pipeline.csv", std::ios_base::app);
+    std::cout.rdbuf(pipelineCSV.rdbuf());
+
+    const std::deque<StageStatistics>& stages = pipeline.statistics();
+    for(unsigned int s = 0; s < stages.size(); s++){
+        std::cout << "\n" << stages[s].name << ", " << stages[s].number_threads << ", " << stages[s].items << ", " << stages[s].busy_ms << ", "
+                  << stages[s].input_stall_ms << ", " << stages[s].output_stall_ms << ", " << stages[s].input_occupancy() << ", " << pipeline_time;
+    }
+    std::cout << std::endl;
+
+    pipelineCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> number of parsing threads (optional)
+ * argv[3] --> number of encoding threads (optional)
+ * argv[4] --> number of encryption threads (optional)
+ * argv[5] --> number of accumulation threads (optional)
+ * argv[6] --> capacity of the queues between the stages (optional)
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <numbers file> [parse threads] [encode threads] [encrypt threads] [accumulate threads] [queue capacity]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Encryption is by far the slowest stage, so it gets every core the other stages do not use
+    unsigned int cores = default_number_threads();
+    unsigned int parse_threads = argc > 2 ? std::stoi(argv[2]) : 1;
+    unsigned int encode_threads = argc > 3 ? std::stoi(argv[3]) : 1;
+    unsigned int encrypt_threads = argc > 4 ? std::stoi(argv[4]) : (cores > 3 ? cores - 3 : 1);
+    unsigned int accumulate_threads = argc > 5 ? std::stoi(argv[5]) : 1;
+    size_t queue_capacity = argc > 6 ? std::stoi(argv[6]) : 8;
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold the sum of all the values
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Every ciphertext is filled with values, and a rotate and sum over a whole row adds them
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t number_rotations = log2(row_size);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the rotation evaluation keys
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, generate_rotation_indexes(number_rotations));
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Pipeline: parse --> encode --> encrypt --> accumulate
+    // The order of the values does not change the sum, so each parsing thread takes the next block of the file
+    // and batches of 2 * row_size values go through the stages in whatever order they are ready
+    std::unique_ptr<MappedNumberFile> numbers_file;
+
+    try{
+        numbers_file.reset(new MappedNumberFile(argv[1]));
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Blocks of about 1MB, so the parsing threads share the work evenly
+    std::vector<std::pair<const char*, const char*>> blocks = numbers_file->blocks(std::max<uint64_t>(parse_threads, numbers_file->bytes() >> 20));
+    std::atomic<size_t> next_block(0);
+    std::atomic<int64_t> total_elements(0);
+
+    PipelineQueue<std::vector<int64_t>> parsedQueue(queue_capacity);
+    PipelineQueue<Plaintext> encodedQueue(queue_capacity);
+    PipelineQueue<Ciphertext<DCRTPoly>> encryptedQueue(queue_capacity);
+
+    // Each accumulation thread adds into its own ciphertext
+    std::vector<Ciphertext<DCRTPoly>> partialSums(accumulate_threads);
+
+    Pipeline pipeline;
+
+    pipeline.addSource("parse", parse_threads, parsedQueue, [&](unsigned int, auto emit) {
+        for(size_t b = next_block++; b < blocks.size(); b = next_block++){
+            parse_number_batches(blocks[b].first, blocks[b].second, 2 * row_size, [&](std::vector<int64_t>&& batch) {
+                total_elements += batch.size();
+                emit(std::move(batch));
+            });
+        }
+    });
+
+    pipeline.addStage("encode", encode_threads, parsedQueue, encodedQueue, [&](std::vector<int64_t> batch) {
+        return cryptoContext->MakePackedPlaintext(batch);
+    });
+
+    pipeline.addStage("encrypt", encrypt_threads, encodedQueue, encryptedQueue, [&](Plaintext plaintext) {
+        return cryptoContext->Encrypt(keyPair.publicKey, plaintext);
+    });
+
+    pipeline.addSink("accumulate", accumulate_threads, encryptedQueue, [&](unsigned int thread, Ciphertext<DCRTPoly> ciphertext) {
+        partialSums[thread] = partialSums[thread] ? cryptoContext->EvalAdd(partialSums[thread], ciphertext) : ciphertext;
+    });
+
+    double pipeline_time;
+
+    try{
+        pipeline_time = pipeline.wait();
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Same check as load_number_file, a truncated or padded file would silently give a different mean
+    if(total_elements != numbers_file->number_vectors * numbers_file->size_vectors){
+        std::cerr << "'" << argv[1] << "' has " << total_elements << " numbers but its header says "
+                  << numbers_file->number_vectors * numbers_file->size_vectors << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Print time spent on the pipeline
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of the pipeline (parse, encode, encrypt and accumulate): " << processingTimes[1] << "ms" << std::endl;
+    pipeline.printStatistics(std::cout);
+
+    TIC(t);
+
+    // Homomorphic Operations
+    std::vector<Ciphertext<DCRTPoly>> sums;
+    for(unsigned int i = 0; i < partialSums.size(); i++){
+        if(partialSums[i]){
+            sums.push_back(partialSums[i]);
+        }
+    }
+
+    if(sums.empty()){
+        std::cerr << "No numbers in the file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto ciphertextAdd = rotate_and_sum(cryptoContext, cryptoContext->EvalAddMany(sums), number_rotations);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    Plaintext plaintextDecAdd;
+
+    cryptoContext->Decrypt(keyPair.secretKey, ciphertextAdd, &plaintextDecAdd);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // The sum is split between the first slot of both rows
+    double mean_sum = plaintextDecAdd->GetPackedValue()[0] + plaintextDecAdd->GetPackedValue()[row_size];
+    double mean = mean_sum / total_elements;
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Values: " << total_elements << " (" << numbers_file->bytes() / (pipeline_time * 1e6) << " GB/s through the pipeline)" << std::endl;
+    std::cout << "Mean: " << mean << std::endl;
+
+    printIntoCSV(processingTimes, total_time, mean, pipeline, pipeline_time);
+}
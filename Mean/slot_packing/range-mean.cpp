@@ -0,0 +1,214 @@
+/**
+ * @file range-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of many range means (mean of elements i to j) over the same data using an encrypted segment tree and Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <random>
+
+#include "../../includes/encryptedSegmentTree.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, uint64_t memory_bytes, double tree_query, double scan_query, int64_t wrong_results){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/rangeMean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nsegment-tree, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+
+    std::cout << memory_bytes << ", " << tree_query << ", " << scan_query << ", " << wrong_results << std::endl;
+
+    meanCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+ * argv[2] --> number of random range queries (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t number_queries = argc > 2 ? std::stoll(argv[2]) : 100;
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t total_elements = all_numbers.size();
+
+    if(total_elements == 0){
+        std::cerr << "The file '" << argv[1] << "' has no numbers" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TimeVar t;
+    // Setup, encryption, tree build
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to hold the sum of the whole data
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    int64_t chunk_size = cryptoContext->GetRingDimension();
+    int64_t row_size = chunk_size / 2;
+    int64_t number_rotations = log2(row_size);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the rotation evaluation keys, every query ends with one rotate and sum
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, generate_rotation_indexes(number_rotations));
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Each chunk fills all the slots, element i of the chunk goes into slot i
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(int64_t begin = 0; begin < total_elements; begin += chunk_size){
+        int64_t end = std::min(begin + chunk_size, total_elements);
+
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(std::vector<int64_t>(all_numbers.begin() + begin, all_numbers.begin() + end));
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Build the tree once, every query reuses it
+    EncryptedSegmentTree tree(cryptoContext, ciphertexts);
+
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of tree build: " << processingTimes[2] << "ms" << std::endl;
+
+    uint64_t memory_bytes = tree.memoryBytes();
+    std::cout << "Tree nodes: " << tree.numberNodes() << " (" << tree.numberChunks() << " chunks)" << std::endl;
+    std::cout << "Tree memory: " << memory_bytes << " bytes (" << (double)memory_bytes / tree.numberNodes() * tree.numberChunks() << " bytes for the chunks alone)" << std::endl;
+
+    // Random ranges, the same for every run
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<int64_t> position(0, total_elements - 1);
+
+    std::vector<double> tree_latencies, scan_latencies;
+    int64_t wrong_results = 0;
+
+    for(int64_t q = 0; q < number_queries; q++){
+        int64_t first = position(generator);
+        int64_t last = position(generator);
+        if(first > last){
+            std::swap(first, last);
+        }
+
+        // Homomorphic Operations with the tree
+        TIC(t);
+        auto rangeCiphertext = tree.rangeSum(first, last);
+        tree_latencies.push_back(TOC(t));
+
+        // Same range adding every chunk of the range, as without the tree
+        TIC(t);
+        int64_t first_chunk = first / chunk_size;
+        int64_t last_chunk = last / chunk_size;
+        std::vector<Ciphertext<DCRTPoly>> rangeChunks;
+
+        for(int64_t c = first_chunk; c <= last_chunk; c++){
+            int64_t first_slot = c == first_chunk ? first % chunk_size : 0;
+            int64_t last_slot = c == last_chunk ? last % chunk_size : chunk_size - 1;
+
+            if(first_slot == 0 && last_slot == chunk_size - 1){
+                rangeChunks.push_back(ciphertexts[c]);
+            }
+            else{
+                rangeChunks.push_back(tree.maskedChunk(c, first_slot, last_slot));
+            }
+        }
+        auto scanCiphertext = rotate_and_sum(cryptoContext, cryptoContext->EvalAddMany(rangeChunks), number_rotations);
+        scan_latencies.push_back(TOC(t));
+
+        // Decryption
+        Plaintext plaintextRange;
+        cryptoContext->Decrypt(keyPair.secretKey, rangeCiphertext, &plaintextRange);
+
+        // Plaintext Operations
+        int64_t range_sum = read_segment_sum(plaintextRange->GetPackedValue(), 0, row_size, row_size);
+        double range_mean = (double)range_sum / (last - first + 1);
+
+        int64_t expected_sum = std::accumulate(all_numbers.begin() + first, all_numbers.begin() + last + 1, (int64_t)0);
+        if(range_sum != expected_sum){
+            wrong_results++;
+        }
+
+        if(q < 5){
+            std::cout << "Mean of elements " << first << " to " << last << ": " << range_mean << std::endl;
+        }
+    }
+
+    double tree_query = std::reduce(tree_latencies.begin(), tree_latencies.end()) / tree_latencies.size();
+    double scan_query = std::reduce(scan_latencies.begin(), scan_latencies.end()) / scan_latencies.size();
+
+    std::cout << "Queries: " << number_queries << std::endl;
+    std::cout << "Average query with the tree: " << tree_query << "ms (p50 " << percentile(tree_latencies, 0.5) << "ms, p99 " << percentile(tree_latencies, 0.99) << "ms)" << std::endl;
+    std::cout << "Average query adding every chunk: " << scan_query << "ms (p50 " << percentile(scan_latencies, 0.5) << "ms, p99 " << percentile(scan_latencies, 0.99) << "ms)" << std::endl;
+    std::cout << "Wrong results: " << wrong_results << std::endl;
+
+    printIntoCSV(processingTimes, memory_bytes, tree_query, scan_query, wrong_results);
+}
@@ -0,0 +1,246 @@
+/**
+ * @file sliding-window-mean.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of a moving average over a stream of blocks using Slot Packing, with constant work per step
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double sliding_step, double recompute_step, double mean){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream meanCSV("timeCSVs/mean.csv", std::ios_base::app);
+    std::cout.rdbuf(meanCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nsliding-window, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << sliding_step << ", " << recompute_step << ", " << mean << std::endl;
+
+    meanCSV.close();
+}
+
+/*
+ * Each vector of the number's file is one block of the time series (e.g. one day)
+ *
+ * argv[1] --> number's file name
+ * argv[2] --> window size, in blocks (optional)
+ * argv[3] --> window size, in slots, of the moving average inside the last block (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t window_blocks = argc > 2 ? std::stoll(argv[2]) : 7;
+    int64_t window_slots = argc > 3 ? std::stoll(argv[3]) : 0;
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    if(window_blocks < 1 || window_blocks > number_vectors){
+        std::cerr << "The window has to be between 1 and " << number_vectors << " blocks" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TimeVar t;
+    // Setup, encryption, homomorphic operations, decryption, plaintext operations
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to hold the sum of a whole window
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each block is reduced over a whole row, so the block sum ends in the first slot of both rows
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t number_rotations = log2(row_size);
+
+    if(window_slots >= row_size){
+        std::cerr << "The moving average window has to be smaller than " << row_size << " slots" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the rotation evaluation keys of the block sums and of the moving average
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(number_rotations);
+    if(window_slots > 0){
+        std::vector<int32_t> window_indexes = moving_window_rotation_indexes(window_slots);
+        rotation_indexes.insert(rotation_indexes.end(), window_indexes.begin(), window_indexes.end());
+    }
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    // Stream the blocks
+    // The ring buffer keeps the reduced sum of the last window_blocks blocks, the window sum is updated
+    // by adding the incoming block and subtracting the one that leaves the window
+    std::vector<Ciphertext<DCRTPoly>> blockSums(window_blocks);
+    Ciphertext<DCRTPoly> windowSum;
+    Ciphertext<DCRTPoly> lastBlock;
+
+    std::vector<double> sliding_steps, recompute_steps;
+    std::vector<double> means;
+
+    for(int64_t block = 0; block < number_vectors; block++){
+        std::vector<int64_t> block_numbers(all_numbers.begin() + block * size_vectors, all_numbers.begin() + (block + 1) * size_vectors);
+
+        TIC(t);
+
+        // Encode Plaintext with slot packing and encrypt it, a block bigger than the ring takes more than one ciphertext
+        std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+        std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(block_numbers, row_size, row_size);
+
+        for(unsigned int i = 0; i < packed_numbers.size(); i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+            ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+        }
+        lastBlock = ciphertexts[0];
+
+        processingTimes[1] += TOC(t);
+
+        TIC(t);
+
+        // Homomorphic Operations
+        // Every block is reduced only once, when it arrives
+        auto blockSum = rotate_and_sum(cryptoContext, cryptoContext->EvalAddMany(ciphertexts), number_rotations);
+
+        TimeVar step;
+        TIC(step);
+
+        int64_t position = block % window_blocks;
+
+        if(block >= window_blocks){
+            windowSum = cryptoContext->EvalSub(windowSum, blockSums[position]);
+        }
+        blockSums[position] = blockSum;
+        windowSum = windowSum ? cryptoContext->EvalAdd(windowSum, blockSum) : blockSum;
+
+        sliding_steps.push_back(TOC(step));
+        processingTimes[2] += TOC(t);
+
+        // Nothing to report until the first window is full
+        if(block < window_blocks - 1){
+            continue;
+        }
+
+        // Same window sum, recalculated from all the block sums of the window
+        TIC(step);
+        auto recomputedSum = cryptoContext->EvalAddMany(blockSums);
+        recompute_steps.push_back(TOC(step));
+
+        TIC(t);
+
+        // Decryption
+        Plaintext plaintextDecAdd;
+
+        cryptoContext->Decrypt(keyPair.secretKey, windowSum, &plaintextDecAdd);
+
+        processingTimes[3] += TOC(t);
+
+        TIC(t);
+
+        // Plaintext Operations
+        int64_t window_sum = read_segment_sum(plaintextDecAdd->GetPackedValue(), 0, row_size, row_size);
+        means.push_back((double)window_sum / (window_blocks * size_vectors));
+
+        processingTimes[4] += TOC(t);
+    }
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    double sliding_step = std::reduce(sliding_steps.begin(), sliding_steps.end()) / sliding_steps.size();
+    double recompute_step = std::reduce(recompute_steps.begin(), recompute_steps.end()) / recompute_steps.size();
+
+    std::cout << "Average window update: " << sliding_step << "ms" << std::endl;
+    std::cout << "Average window recalculation: " << recompute_step << "ms" << std::endl;
+
+    for(size_t i = 0; i < means.size(); i++){
+        std::cout << "Mean of blocks " << i << " to " << i + window_blocks - 1 << ": " << means[i] << std::endl;
+    }
+
+    // Moving average inside the last block, over its first row
+    if(window_slots > 0){
+        TIC(t);
+        auto movingSum = moving_window_sum(cryptoContext, lastBlock, window_slots);
+        double moving_time = TOC(t);
+
+        Plaintext plaintextMoving;
+        cryptoContext->Decrypt(keyPair.secretKey, movingSum, &plaintextMoving);
+
+        // Only the windows that fit in the values of the first row are complete
+        int64_t values_first_row = std::min(size_vectors, row_size);
+        int64_t number_windows = std::max<int64_t>(values_first_row - window_slots + 1, 0);
+
+        std::cout << "Duration of the moving average (" << window_slots << " slots): " << moving_time << "ms" << std::endl;
+        std::cout << "Moving average of the last block:";
+        for(int64_t j = 0; j < std::min<int64_t>(number_windows, 16); j++){
+            std::cout << " " << (double)plaintextMoving->GetPackedValue()[j] / window_slots;
+        }
+        std::cout << (number_windows > 16 ? " ..." : "") << std::endl;
+    }
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Mean of the last window: " << means.back() << std::endl;
+
+    printIntoCSV(processingTimes, total_time, sliding_step, recompute_step, means.back());
+}
@@ -0,0 +1,205 @@
+/**
+ * @file prefix-sum.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the cumulative sums (inclusive scan) of n values using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, int64_t wrong_results){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream prefixSumCSV("timeCSVs/prefixSum.csv", std::ios_base::app);
+    std::cout.rdbuf(prefixSumCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nhillis-steele, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << wrong_results << std::endl;
+
+    prefixSumCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    int64_t total_elements = all_numbers.size();
+
+    if(total_elements == 0){
+        std::cerr << "The file '" << argv[1] << "' has no numbers" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to hold the sum of all the values
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each chunk only uses the first half of the first row, the empty slots keep the scan from wrapping around
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t chunk_size = row_size / 2;
+    int64_t number_steps = log2(chunk_size);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the rotation evaluation keys of the scan (right rotations) and of the chunk totals (left rotations)
+    std::vector<int32_t> rotation_indexes = generate_scan_rotation_indexes(number_steps);
+    std::vector<int32_t> total_indexes = generate_rotation_indexes(log2(row_size));
+    rotation_indexes.insert(rotation_indexes.end(), total_indexes.begin(), total_indexes.end());
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(int64_t begin = 0; begin < total_elements; begin += chunk_size){
+        int64_t end = std::min(begin + chunk_size, total_elements);
+
+        // Encode Plaintext with slot packing, the values only fill the first slots so the rest stays zero
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(std::vector<int64_t>(all_numbers.begin() + begin, all_numbers.begin() + end));
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Scan each chunk and carry the total of the previous chunks into it
+    std::vector<Ciphertext<DCRTPoly>> scanCiphertexts = inclusive_scan_chunks(cryptoContext, ciphertexts, number_steps);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    std::vector<int64_t> prefix_sums;
+
+    for(unsigned int i = 0; i < scanCiphertexts.size(); i++){
+        Plaintext plaintextScan;
+        cryptoContext->Decrypt(keyPair.secretKey, scanCiphertexts[i], &plaintextScan);
+
+        int64_t chunk_values = std::min(chunk_size, total_elements - (int64_t)i * chunk_size);
+        const std::vector<int64_t>& slots = plaintextScan->GetPackedValue();
+
+        prefix_sums.insert(prefix_sums.end(), slots.begin(), slots.begin() + chunk_values);
+    }
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // Check every cumulative sum against the plaintext one
+    int64_t wrong_results = 0, expected_sum = 0;
+
+    for(int64_t i = 0; i < total_elements; i++){
+        expected_sum += all_numbers[i];
+
+        if(prefix_sums[i] != expected_sum){
+            wrong_results++;
+        }
+    }
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+
+    // Cumulative share of the total at every 10% of the values
+    int64_t total_sum = prefix_sums.back();
+    for(int decile = 1; decile <= 10; decile++){
+        int64_t position = std::max<int64_t>(total_elements * decile / 10 - 1, 0);
+
+        std::cout << "Cumulative sum of the first " << decile * 10 << "%: " << prefix_sums[position]
+                  << " (" << (total_sum != 0 ? 100.0 * prefix_sums[position] / total_sum : 0) << "% of the total)" << std::endl;
+    }
+
+    std::cout << "Wrong results: " << wrong_results << std::endl;
+
+    printIntoCSV(processingTimes, total_time, wrong_results);
+}
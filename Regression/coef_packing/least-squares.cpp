@@ -0,0 +1,334 @@
+/**
+ * @file least-squares.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of ordinary least squares (X^T X and X^T y) using coefficient packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/coefEntryLayout.h"
+#include "../../includes/parallelMapReduce.h"
+#include "../../includes/partialDecryption.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, int64_t number_features, int64_t number_decryptions, double r_squared){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream regressionCSV("timeCSVs/regression.csv", std::ios_base::app);
+    std::cout.rdbuf(regressionCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\ncoef, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << number_features << ", " << number_decryptions << ", " << r_squared << std::endl;
+
+    regressionCSV.close();
+}
+
+// Solve A*x = b with Gaussian elimination and partial pivoting, A is the small (k+1)x(k+1) system of the normal equations
+std::vector<long double> solveSystem(std::vector<std::vector<long double>> A, std::vector<long double> b){
+    int64_t size = b.size();
+
+    for(int64_t column = 0; column < size; column++){
+        int64_t pivot = column;
+        for(int64_t row = column + 1; row < size; row++){
+            if(fabsl(A[row][column]) > fabsl(A[pivot][column])){
+                pivot = row;
+            }
+        }
+
+        if(A[pivot][column] == 0){
+            throw std::runtime_error("The normal equations are singular, some features are linearly dependent");
+        }
+
+        std::swap(A[column], A[pivot]);
+        std::swap(b[column], b[pivot]);
+
+        for(int64_t row = column + 1; row < size; row++){
+            long double factor = A[row][column] / A[column][column];
+
+            for(int64_t c = column; c < size; c++){
+                A[row][c] -= factor * A[column][c];
+            }
+            b[row] -= factor * b[column];
+        }
+    }
+
+    std::vector<long double> x(size);
+    for(int64_t row = size - 1; row >= 0; row--){
+        long double value = b[row];
+        for(int64_t c = row + 1; c < size; c++){
+            value -= A[row][c] * x[c];
+        }
+        x[row] = value / A[row][row];
+    }
+
+    return x;
+}
+
+/*
+ * argv[1] --> number's file name, each vector is one column: the first number_vectors - 1 are the features and the last one is y
+ * argv[2] --> length of the chunks each column is split into, a power of 2 (optional)
+ * argv[3] --> number of threads (optional)
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    // y is handled as one more column, so X^T X, X^T y and y^T y are all cross sums between columns
+    int64_t number_columns = number_vectors;
+    int64_t number_features = number_columns - 1;
+    std::vector<std::vector<int64_t>> columns;
+
+    for(int64_t c = 0; c < number_columns; c++){
+        columns.push_back(std::vector<int64_t>(all_numbers.begin() + c * size_vectors, all_numbers.begin() + (c + 1) * size_vectors));
+    }
+
+    unsigned int number_threads = argc > 3 ? std::stoi(argv[3]) : default_number_threads();
+    ThreadPool pool(number_threads);
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold sum(x_a * x_b)
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Same layout as the coef covariance matrix, the entries are the sum of every column (X^T 1 and 1^T y, for the intercept)
+    // and the cross sum of every pair a <= b
+    CoefEntryLayout layout(cryptoContext, number_columns, argc > 2 ? std::stoll(argv[2]) : 0);
+
+    const std::vector<std::pair<int64_t, int64_t>>& entries = layout.getEntries();
+    int64_t number_entries = layout.numberEntries();
+    int64_t chunk_length = layout.chunkLength();
+    int64_t number_chunks = ceil((double)size_vectors / chunk_length);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key, no rotation keys are needed
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Each block of rows holds, for every column, its chunk as it is followed by its reversed chunk
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> rowBlocks(number_chunks);
+
+    for(int64_t i = 0; i < number_chunks; i++){
+        for(int64_t c = 0; c < number_columns; c++){
+            std::vector<int64_t> chunk(columns[c].begin() + i * chunk_length, columns[c].begin() + std::min((i + 1) * chunk_length, size_vectors));
+            chunk.resize(chunk_length, 0);
+
+            rowBlocks[i].push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakeCoefPackedPlaintext(chunk)));
+
+            reverse(chunk.begin(), chunk.end());
+            rowBlocks[i].push_back(cryptoContext->Encrypt(keyPair.publicKey, cryptoContext->MakeCoefPackedPlaintext(chunk)));
+        }
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+
+    // Every block of rows gives its contribution to each entry: the chunk of the column for the sums
+    // and the product of the chunk by the reversed chunk of the other column for the cross sums.
+    // The products are not relinearized, each thread adds them straight into its own accumulator
+    auto blockEntries = [&](const std::vector<Ciphertext<DCRTPoly>>& block){
+        std::vector<Ciphertext<DCRTPoly>> contributions;
+
+        for(int64_t e = 0; e < number_entries; e++){
+            int64_t a = entries[e].first;
+            int64_t b = entries[e].second;
+
+            if(b < 0){
+                contributions.push_back(block[2 * a]);
+            }
+            else{
+                contributions.push_back(cryptoContext->EvalMultNoRelin(block[2 * a], block[2 * b + 1]));
+            }
+        }
+
+        return contributions;
+    };
+
+    auto addEntries = [&](const std::vector<Ciphertext<DCRTPoly>>& left, const std::vector<Ciphertext<DCRTPoly>>& right){
+        std::vector<Ciphertext<DCRTPoly>> sums;
+
+        for(unsigned int e = 0; e < left.size(); e++){
+            sums.push_back(cryptoContext->EvalAdd(left[e], right[e]));
+        }
+
+        return sums;
+    };
+
+    std::vector<Ciphertext<DCRTPoly>> entryCiphertexts = parallel_map_reduce(rowBlocks, blockEntries, addEntries, pool);
+
+    // Move every entry into its place and relinearize each result ciphertext only once
+    std::vector<Ciphertext<DCRTPoly>> resultCiphertexts = layout.placeEntries(entryCiphertexts);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // All the result ciphertexts are decrypted in one batch, reading only the coefficients with entries
+    std::vector<std::vector<int64_t>> decrypted = decrypt_coefficients_batch(cryptoContext, keyPair.secretKey, resultCiphertexts, layout.entryIndexes(), pool);
+
+    std::vector<int64_t> entry_values;
+    for(unsigned int r = 0; r < decrypted.size(); r++){
+        entry_values.insert(entry_values.end(), decrypted[r].begin(), decrypted[r].end());
+    }
+    entry_values.resize(number_entries);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    // cross[a][b] = sum(x_a * x_b), with column number_features being y
+    std::vector<std::vector<long double>> cross(number_columns, std::vector<long double>(number_columns));
+    int64_t wrong_results = 0;
+
+    for(int64_t e = number_columns; e < number_entries; e++){
+        int64_t a = entries[e].first;
+        int64_t b = entries[e].second;
+
+        cross[a][b] = entry_values[e];
+        cross[b][a] = entry_values[e];
+
+        // Check the cross sum against the plaintext one
+        int64_t expected = 0;
+        for(int64_t i = 0; i < size_vectors; i++){
+            expected += columns[a][i] * columns[b][i];
+        }
+        wrong_results += entry_values[e] != expected;
+    }
+
+    for(int64_t a = 0; a < number_columns; a++){
+        wrong_results += entry_values[a] != std::accumulate(columns[a].begin(), columns[a].end(), (int64_t)0);
+    }
+
+    // Normal equations with an intercept: the first row and column of X^T X are n and the column sums
+    int64_t y = number_features;
+    std::vector<std::vector<long double>> gram(number_features + 1, std::vector<long double>(number_features + 1));
+    std::vector<long double> moments(number_features + 1);
+
+    gram[0][0] = size_vectors;
+    moments[0] = entry_values[y];
+
+    for(int64_t a = 0; a < number_features; a++){
+        gram[0][a + 1] = entry_values[a];
+        gram[a + 1][0] = entry_values[a];
+        moments[a + 1] = cross[a][y];
+
+        for(int64_t b = 0; b < number_features; b++){
+            gram[a + 1][b + 1] = cross[a][b];
+        }
+    }
+
+    std::vector<long double> beta = solveSystem(gram, moments);
+
+    // RSS = y^T y - 2 beta^T X^T y + beta^T X^T X beta, and TSS = y^T y - sum(y)^2/n
+    long double fitted = 0;
+    for(int64_t a = 0; a <= number_features; a++){
+        fitted -= 2 * beta[a] * moments[a];
+        for(int64_t b = 0; b <= number_features; b++){
+            fitted += beta[a] * gram[a][b] * beta[b];
+        }
+    }
+
+    long double residual_sum = cross[y][y] + fitted;
+    long double total_sum = cross[y][y] - (long double)entry_values[y] * entry_values[y] / size_vectors;
+    double r_squared = 1 - residual_sum / total_sum;
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Entries: " << number_entries << " in " << resultCiphertexts.size() << " decryptions" << std::endl;
+
+    std::cout << "Intercept: " << (double)beta[0] << std::endl;
+    for(int64_t a = 0; a < number_features; a++){
+        std::cout << "Coefficient " << a << ": " << (double)beta[a + 1] << std::endl;
+    }
+
+    std::cout << "R^2: " << r_squared << std::endl;
+    std::cout << "Wrong results: " << wrong_results << std::endl;
+
+    printIntoCSV(processingTimes, total_time, number_features, resultCiphertexts.size(), r_squared);
+}
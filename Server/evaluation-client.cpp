@@ -0,0 +1,253 @@
+/**
+ * @file evaluation-client.cpp
+ * @author Bernardo Ramalho
+ * @brief Client of the evaluation server: generates the keys, sends encrypted queries and reports their latency
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+#include "../includes/homomorphicStatistics.h"
+#include "../includes/serialization.h"
+#include "../includes/socketProtocol.h"
+
+using namespace lbcrypto;
+
+// Generate the context and every key the server needs, and save them together with the secret key
+int setup(const std::string& keys_directory){
+    TimeVar t;
+    TIC(t);
+
+    CryptoContext<DCRTPoly> cryptoContext = make_statistics_context();
+    KeyPair<DCRTPoly> keyPair = generate_statistics_keys(cryptoContext);
+
+    save_keys(keys_directory, cryptoContext, keyPair);
+
+    std::cout << "Duration of setup: " << TOC(t) << "ms" << std::endl;
+    std::cout << "Keys written to " << keys_directory << std::endl;
+
+    return 0;
+}
+
+// The inner product reads two lines, one per vector. The other statistics read the number_vectors/size_vectors file.
+// Throws std::runtime_error if there are no numbers or the vectors have different lengths
+std::vector<std::vector<int64_t>> readVectors(std::ifstream& numbers_file, const std::string& statistic){
+    std::vector<std::vector<int64_t>> vectors;
+    int64_t number;
+
+    if(statistic == "inner-product"){
+        std::string vector_line;
+
+        while(std::getline(numbers_file, vector_line)){
+            std::istringstream line(vector_line);
+
+            std::vector<int64_t> v;
+            while (line >> number) {
+                v.push_back(number);
+            }
+
+            if(!v.empty()){
+                vectors.push_back(v);
+            }
+        }
+    }
+    else{
+        int64_t number_vectors, size_vectors;
+        numbers_file >> number_vectors;
+        numbers_file >> size_vectors;
+
+        std::vector<int64_t> all_numbers;
+        while (numbers_file >> number) {
+            all_numbers.push_back(number);
+        }
+
+        vectors.push_back(all_numbers);
+    }
+
+    // The inner product pairs the chunks of the first vector with the ones of the second, so they must have the same length
+    if(vectors.empty() || vectors[0].empty()){
+        throw std::runtime_error("No numbers in the file");
+    }
+
+    for(size_t v = 1; v < vectors.size(); v++){
+        if(vectors[v].size() != vectors[0].size()){
+            throw std::runtime_error("Vector " + std::to_string(v) + " has " + std::to_string(vectors[v].size())
+                                     + " numbers but vector 0 has " + std::to_string(vectors[0].size()));
+        }
+    }
+
+    return vectors;
+}
+
+// Send the same encrypted query number_requests times over concurrent connections and report the latencies
+int query(const std::string& keys_directory, const std::string& socket_path, const std::string& numbers_path,
+          const std::string& statistic, int number_requests, int number_connections){
+    std::ifstream numbers_file (numbers_path);
+
+    if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << numbers_path << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(!is_valid_statistic(statistic)){
+        std::cerr << "Unknown statistic '" << statistic << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(number_requests < 1 || number_connections < 1){
+        std::cerr << "The number of requests and of connections must be at least 1" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::vector<int64_t>> vectors;
+    try{
+        vectors = readVectors(numbers_file, statistic);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << " - '" << numbers_path << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+    int64_t total_elements = vectors[0].size();
+
+    CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+    PublicKey<DCRTPoly> publicKey = load_public_key(keys_directory);
+    PrivateKey<DCRTPoly> secretKey = load_secret_key(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    // Encrypt and serialize the data only once, every request sends the same batch
+    EvaluationRequest request;
+    request.statistic = statistic;
+
+    for(size_t v = 0; v < vectors.size(); v++){
+        std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(vectors[v], layout.segment_width, layout.row_size);
+
+        for(size_t i = 0; i < packed_numbers.size(); i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+            request.ciphertexts.push_back(serialize_ciphertext(cryptoContext->Encrypt(publicKey, plaintext)));
+        }
+    }
+
+    std::string payload = encode_request(request);
+
+    // Each connection sends requests until all of them are done
+    std::atomic<int> next_request(0);
+    std::vector<std::vector<double>> connection_latencies(number_connections);
+    std::vector<std::string> connection_errors(number_connections);
+    std::string last_response;
+    std::mutex response_mutex;
+
+    TimeVar t;
+    TIC(t);
+
+    std::vector<std::thread> connections;
+    for(int c = 0; c < number_connections; c++){
+        connections.emplace_back([&, c]() {
+            try{
+                int fd = connect_unix_socket(socket_path);
+
+                while(next_request++ < number_requests){
+                    TimeVar request_time;
+                    TIC(request_time);
+
+                    std::string response;
+                    write_frame(fd, payload);
+                    if(!read_frame(fd, response)){
+                        throw std::runtime_error("Server closed the connection");
+                    }
+
+                    connection_latencies[c].push_back(TOC(request_time));
+
+                    if(response.empty() || response[0] != RESPONSE_OK){
+                        throw std::runtime_error("Server error: " + (response.empty() ? std::string("empty response") : response.substr(1)));
+                    }
+
+                    std::lock_guard<std::mutex> lock(response_mutex);
+                    last_response = response.substr(1);
+                }
+
+                close(fd);
+            }
+            catch(const std::exception& e){
+                connection_errors[c] = e.what();
+            }
+        });
+    }
+
+    for(size_t c = 0; c < connections.size(); c++){
+        connections[c].join();
+    }
+
+    double total_time = TOC(t);
+
+    for(size_t c = 0; c < connection_errors.size(); c++){
+        if(!connection_errors[c].empty()){
+            std::cerr << "Connection " << c << " failed: " << connection_errors[c] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<double> latencies;
+    for(size_t c = 0; c < connection_latencies.size(); c++){
+        latencies.insert(latencies.end(), connection_latencies[c].begin(), connection_latencies[c].end());
+    }
+
+    // Decrypt one of the results to check it
+    Plaintext plaintextResult;
+    cryptoContext->Decrypt(secretKey, deserialize_ciphertext(last_response), &plaintextResult);
+    double value = finish_statistic(statistic, plaintextResult->GetPackedValue(), layout, total_elements);
+
+    std::cout << "Requests: " << latencies.size() << " over " << number_connections << " connections" << std::endl;
+    std::cout << "Request size: " << payload.size() << " bytes" << std::endl;
+    std::cout << "Total time: " << total_time << "ms" << std::endl;
+    std::cout << "Throughput: " << latencies.size() / (total_time / 1000) << " requests/s" << std::endl;
+    std::cout << "p50 request latency: " << percentile(latencies, 0.5) << "ms" << std::endl;
+    std::cout << "p99 request latency: " << percentile(latencies, 0.99) << "ms" << std::endl;
+    std::cout << statistic << ": " << value << std::endl;
+
+    return 0;
+}
+
+/*
+ * argv[1] --> "setup" or "query"
+ *
+ * setup:
+ *   argv[2] --> keys directory
+ *
+ * query:
+ *   argv[2] --> keys directory
+ *   argv[3] --> socket path of the server
+ *   argv[4] --> number's file name
+ *   argv[5] --> statistic (mean, inner-product or variance)
+ *   argv[6] --> number of requests (optional)
+ *   argv[7] --> number of concurrent connections (optional)
+*/
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if(mode == "setup" && argc > 2){
+        return setup(argv[2]);
+    }
+
+    if(mode == "query" && argc > 5){
+        int number_requests = argc > 6 ? std::stoi(argv[6]) : 100;
+        int number_connections = argc > 7 ? std::stoi(argv[7]) : 4;
+
+        return query(argv[2], argv[3], argv[4], argv[5], number_requests, number_connections);
+    }
+
+    std::cerr << "Usage: " << argv[0] << " setup <keys directory>" << std::endl;
+    std::cerr << "       " << argv[0] << " query <keys directory> <socket path> <numbers file> <mean|inner-product|variance> [requests] [connections]" << std::endl;
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file evaluation-server.cpp
+ * @author Bernardo Ramalho
+ * @brief Long lived server that evaluates the mean, inner product and variance over a Unix domain socket
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <mutex>
+#include <set>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../includes/homomorphicStatistics.h"
+#include "../includes/serialization.h"
+#include "../includes/socketProtocol.h"
+#include "../includes/threadPool.h"
+
+using namespace lbcrypto;
+
+// Set by the signal handler to stop accepting connections
+volatile sig_atomic_t stop_server = 0;
+
+// Writing a byte wakes up the poll of the main loop, write is safe to call from a signal handler
+int wake_pipe[2] = {-1, -1};
+
+void wakeMainLoop(){
+    char byte = 0;
+    ssize_t written = write(wake_pipe[1], &byte, 1);
+    (void)written;
+}
+
+void stopServer(int){
+    stop_server = 1;
+    wakeMainLoop();
+}
+
+// Server side latencies of every request, from reading the request until the response is ready
+std::vector<double> request_latencies;
+std::mutex latencies_mutex;
+
+// Every connection that is not closed yet, and the ones that finished a request and wait to be polled again
+std::set<int> open_connections;
+std::vector<int> returned_connections;
+std::mutex connections_mutex;
+
+/*
+ * Read, evaluate and answer one request of the connection. A connection only holds a thread of the pool while it
+ * has a request being served, between requests it goes back to the main loop, so idle clients never keep
+ * other connections waiting.
+ */
+void handleRequest(int client_fd, CryptoContext<DCRTPoly> cryptoContext, SegmentLayout layout){
+    std::string payload;
+    bool keep_open = false;
+
+    try{
+        keep_open = read_frame(client_fd, payload);
+
+        if(keep_open){
+            TimeVar t;
+            TIC(t);
+
+            std::string response;
+
+            try{
+                EvaluationRequest request = decode_request(payload);
+
+                if(!is_valid_statistic(request.statistic)){
+                    throw std::invalid_argument("Unknown statistic '" + request.statistic + "'");
+                }
+
+                std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+                for(size_t i = 0; i < request.ciphertexts.size(); i++){
+                    ciphertexts.push_back(deserialize_ciphertext(request.ciphertexts[i]));
+                }
+
+                Ciphertext<DCRTPoly> result = evaluate_statistic(cryptoContext, request.statistic, ciphertexts, layout);
+
+                response = std::string(1, RESPONSE_OK) + serialize_ciphertext(result);
+            }
+            catch(const std::exception& e){
+                // A bad request is reported back to the client, the connection stays open
+                response = std::string(1, RESPONSE_ERROR) + e.what();
+            }
+
+            double latency = TOC(t);
+            {
+                std::lock_guard<std::mutex> lock(latencies_mutex);
+                request_latencies.push_back(latency);
+            }
+
+            write_frame(client_fd, response);
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "Connection dropped: " << e.what() << std::endl;
+        keep_open = false;
+    }
+
+    std::lock_guard<std::mutex> lock(connections_mutex);
+
+    if(keep_open && !stop_server){
+        returned_connections.push_back(client_fd);
+        wakeMainLoop();
+    }
+    else{
+        open_connections.erase(client_fd);
+        close(client_fd);
+    }
+}
+
+/*
+ * argv[1] --> keys directory, created by "evaluation-client setup"
+ * argv[2] --> socket path
+ * argv[3] --> number of threads handling requests (optional)
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " <keys directory> <socket path> [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string keys_directory = argv[1];
+    std::string socket_path = argv[2];
+    unsigned int number_threads = argc > 3 ? std::stoi(argv[3]) : default_number_threads();
+
+    TimeVar t;
+    TIC(t);
+
+    // The context and the evaluation keys are loaded only once and shared by every request
+    // The secret key is never loaded by the server
+    CryptoContext<DCRTPoly> cryptoContext = load_evaluation_context(keys_directory);
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    std::cout << "Duration of setup: " << TOC(t) << "ms" << std::endl;
+
+    int listen_fd = listen_unix_socket(socket_path, 128);
+
+    // Non blocking, so a full pipe never blocks the signal handler or a thread of the pool
+    if(pipe(wake_pipe) < 0 || fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK) < 0){
+        std::cerr << "Could not create the wake up pipe: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // No SA_RESTART, so poll returns when a signal arrives
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    std::cout << "Listening on " << socket_path << " with " << number_threads << " threads" << std::endl;
+
+    {
+        ThreadPool pool(number_threads);
+
+        // Connections waiting for their next request
+        std::vector<int> idle_connections;
+
+        while(!stop_server){
+            std::vector<pollfd> poll_fds = {{listen_fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+            for(unsigned int i = 0; i < idle_connections.size(); i++){
+                poll_fds.push_back({idle_connections[i], POLLIN, 0});
+            }
+
+            if(poll(poll_fds.data(), poll_fds.size(), -1) < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                break;
+            }
+
+            // A connection with a request (or closed by the client) is handed to the pool until the request is served
+            idle_connections.clear();
+            for(unsigned int i = 2; i < poll_fds.size(); i++){
+                int client_fd = poll_fds[i].fd;
+
+                if(poll_fds[i].revents == 0){
+                    idle_connections.push_back(client_fd);
+                    continue;
+                }
+
+                pool.submit([client_fd, cryptoContext, layout]() {
+                    handleRequest(client_fd, cryptoContext, layout);
+                });
+            }
+
+            if(poll_fds[1].revents & POLLIN){
+                char buffer[64];
+                ssize_t drained = read(wake_pipe[0], buffer, sizeof(buffer));
+                (void)drained;
+
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                idle_connections.insert(idle_connections.end(), returned_connections.begin(), returned_connections.end());
+                returned_connections.clear();
+            }
+
+            if(poll_fds[0].revents & POLLIN){
+                int client_fd = accept(listen_fd, nullptr, nullptr);
+
+                if(client_fd >= 0){
+                    std::lock_guard<std::mutex> lock(connections_mutex);
+                    open_connections.insert(client_fd);
+                    idle_connections.push_back(client_fd);
+                }
+                else if(errno != EINTR && errno != ECONNABORTED){
+                    break;
+                }
+            }
+        }
+
+        // Shutting down every connection makes the requests still being read or answered fail at once,
+        // so the pool only waits for the evaluations already running, not for the clients to disconnect
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            for(std::set<int>::iterator it = open_connections.begin(); it != open_connections.end(); it++){
+                shutdown(*it, SHUT_RDWR);
+            }
+        }
+    }
+
+    // The connections that were idle when the server stopped
+    for(std::set<int>::iterator it = open_connections.begin(); it != open_connections.end(); it++){
+        close(*it);
+    }
+
+    close(listen_fd);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    unlink(socket_path.c_str());
+
+    std::cout << "Requests served: " << request_latencies.size() << std::endl;
+    std::cout << "p50 request latency: " << percentile(request_latencies, 0.5) << "ms" << std::endl;
+    std::cout << "p99 request latency: " << percentile(request_latencies, 0.99) << "ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file csv-statistics.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the count, mean and variance of every column of a CSV file using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+#include "../../includes/csvReader.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, std::string layout, int64_t number_columns, int64_t number_rows, int64_t number_decryptions){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream statisticsCSV("timeCSVs/statistics.csv", std::ios_base::app);
+    std::cout.rdbuf(statisticsCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\ncsv-" << layout << ", ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << number_columns << ", " << number_rows << ", " << number_decryptions << std::endl;
+
+    statisticsCSV.close();
+}
+
+/*
+ * argv[1] --> CSV file name, the first line has the names of the columns
+ * argv[2] --> number of decimals kept from each value (optional, 0 by default)
+ * argv[3] --> layout of the columns: "interleaved" (default) or "column" (one column per ciphertext)
+ * argv[4] --> number of threads used to read the file (optional)
+*/
+int main(int argc, char *argv[]) {
+    if(argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <csv file> [decimals] [interleaved|column] [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int decimals = argc > 2 ? std::stoi(argv[2]) : 0;
+    std::string layout = argc > 3 ? argv[3] : "interleaved";
+    unsigned int number_threads = argc > 4 ? std::stoi(argv[4]) : default_number_threads();
+
+    if(layout != "interleaved" && layout != "column"){
+        std::cerr << "Unknown layout '" << layout << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Read the columns from the file
+    CsvColumns csv;
+
+    try{
+        csv = read_csv_columns(argv[1], decimals, number_threads);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t number_columns = csv.values.size();
+    int64_t number_rows = csv.values[0].size();
+
+    // Print time spent reading the file
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of reading: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold sum(x^2), with x already multiplied by 10^decimals
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Interleaved: the sums of the columns end in the first number_columns segments and the sums of the squares in the next ones.
+    // Column: each column is on its own, as in the fused statistics, with its sum in the first segment and its sum of squares in the second
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t number_segments = layout == "interleaved" ? pow(2, ceil(log2(2 * number_columns))) : 2;
+
+    if(number_segments > row_size){
+        std::cerr << "Too many columns for the interleaved layout, use the column layout" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t segment_width = row_size / number_segments;
+    int64_t squares_segment = number_segments / 2;
+
+    // The rotate and sum only has to cover one segment
+    int64_t number_rotations = log2(segment_width);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys of the shared rotate and sum, plus the one that moves the sums of the squares into their segments
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(number_rotations);
+    rotation_indexes.push_back(segment_rotation_index(squares_segment, segment_width, row_size));
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // Interleaved: a single group of ciphertexts holds every column. Column: one group of ciphertexts per column
+    std::vector<std::vector<std::vector<int64_t>>> packed_groups;
+
+    if(layout == "interleaved"){
+        packed_groups.push_back(pack_interleaved_columns(csv.values, segment_width, row_size));
+    }
+    else{
+        for(int64_t c = 0; c < number_columns; c++){
+            packed_groups.push_back(pack_first_segment(csv.values[c], segment_width, row_size));
+        }
+    }
+
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> ciphertextGroups(packed_groups.size());
+
+    for(unsigned int g = 0; g < packed_groups.size(); g++){
+        for(unsigned int i = 0; i < packed_groups[g].size(); i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_groups[g][i]);
+            ciphertextGroups[g].push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+        }
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+    // Each group gets the fused statistics treatment: the squares are relinearized once, moved next to the sums
+    // and both are reduced by the same rotate and sum
+    std::vector<Ciphertext<DCRTPoly>> resultCiphertexts;
+
+    for(unsigned int g = 0; g < ciphertextGroups.size(); g++){
+        std::vector<Ciphertext<DCRTPoly>> squareCiphertexts;
+
+        for(unsigned int i = 0; i < ciphertextGroups[g].size(); i++){
+            squareCiphertexts.push_back(cryptoContext->EvalMultNoRelin(ciphertextGroups[g][i], ciphertextGroups[g][i]));
+        }
+
+        auto sumCiphertext = cryptoContext->EvalAddMany(ciphertextGroups[g]);
+        auto squareSumCiphertext = cryptoContext->Relinearize(cryptoContext->EvalAddMany(squareCiphertexts));
+
+        squareSumCiphertext = cryptoContext->EvalRotate(squareSumCiphertext, segment_rotation_index(squares_segment, segment_width, row_size));
+        auto resultCiphertext = cryptoContext->EvalAdd(sumCiphertext, squareSumCiphertext);
+
+        resultCiphertexts.push_back(rotate_and_sum(cryptoContext, resultCiphertext, number_rotations));
+    }
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    std::vector<std::vector<int64_t>> decryptedSlots;
+
+    for(unsigned int g = 0; g < resultCiphertexts.size(); g++){
+        Plaintext plaintextResult;
+        cryptoContext->Decrypt(keyPair.secretKey, resultCiphertexts[g], &plaintextResult);
+
+        decryptedSlots.push_back(plaintextResult->GetPackedValue());
+    }
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[4] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    std::vector<double> means, variances;
+
+    for(int64_t c = 0; c < number_columns; c++){
+        // Interleaved: column c is in segment c of the only result. Column: it is in segment 0 of its own result
+        const std::vector<int64_t>& slots = decryptedSlots[layout == "interleaved" ? 0 : c];
+        int64_t segment = layout == "interleaved" ? c : 0;
+
+        int64_t sum = read_segment_sum(slots, segment, segment_width, row_size);
+        int64_t square_sum = read_segment_sum(slots, squares_segment + segment, segment_width, row_size);
+
+        // Undo the fixed point scaling: sum(x) is scaled by 10^decimals and sum(x^2) by 10^(2*decimals)
+        long double scale = csv.scale;
+
+        means.push_back(sum / scale / number_rows);
+        variances.push_back(((long double)number_rows * square_sum - (long double)sum * sum) / pow(number_rows, 2) / (scale * scale));
+    }
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[5] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[5] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Rows: " << number_rows << ", columns: " << number_columns << ", decryptions: " << resultCiphertexts.size() << std::endl;
+
+    for(int64_t c = 0; c < number_columns; c++){
+        std::cout << csv.names[c] << ": mean " << means[c] << ", variance " << variances[c] << std::endl;
+    }
+
+    printIntoCSV(processingTimes, total_time, layout, number_columns, number_rows, resultCiphertexts.size());
+}
@@ -0,0 +1,177 @@
+/**
+ * @file fused-statistics.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the count, mean and variance of n values in a single pass using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/homomorphicStatistics.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double mean, double variance){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream statisticsCSV("timeCSVs/statistics.csv", std::ios_base::app);
+    std::cout.rdbuf(statisticsCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nfused, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+
+    std::cout << mean << ", " << variance << std::endl;
+
+    statisticsCSV.close();
+}
+
+/*
+ * argv[1] --> number's file name
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    int64_t total_elements = size_vectors * number_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    TimeVar t;
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    TIC(t);
+
+    // Set CryptoContext
+    // The plaintext modulus has to be big enough to hold sum(x^2)
+    CryptoContext<DCRTPoly> cryptoContext = make_statistics_context();
+
+    // Each row is split in two segments: sum(x) ends in the first one and sum(x^2) in the second one.
+    // The rotate and sum only has to cover one segment
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys, shared by both sums, plus the one that moves sum(x^2) into the second segment
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, statistics_rotation_indexes(layout));
+
+    // Print time spent on setup
+    TOC(t);
+    processingTimes[0] = TOC(t);
+
+    std::cout << "Duration of setup: " << processingTimes[0] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // The data is encrypted only once, with the values in the first segment of each row
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+    std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(all_numbers, layout.segment_width, layout.row_size);
+
+    for(unsigned int i = 0; i < packed_numbers.size(); i++){
+        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    TOC(t);
+    processingTimes[1] = TOC(t);
+
+    std::cout << "Duration of encryption: " << processingTimes[1] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+
+    // Calculate sum(x) and sum(x^2) over the same ciphertexts, with sum(x^2) moved into the second segment
+    // so one rotate and sum reduces both segments at the same time
+    auto resultCiphertext = evaluate_sum_and_square_sum(cryptoContext, ciphertexts, layout);
+
+    // Print time spent on homomorphic operations
+    TOC(t);
+    processingTimes[2] = TOC(t);
+
+    std::cout << "Duration of homomorphic operations: " << processingTimes[2] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // Both sums come out of the same decryption
+    Plaintext plaintextDecAdd;
+
+    cryptoContext->Decrypt(keyPair.secretKey, resultCiphertext, &plaintextDecAdd);
+
+    // Print time spent on decryption
+    TOC(t);
+    processingTimes[3] = TOC(t);
+
+    std::cout << "Duration of decryption: " << processingTimes[3] << "ms" << std::endl;
+
+    TIC(t);
+
+    // Plaintext Operations
+    std::vector<int64_t> slots = plaintextDecAdd->GetPackedValue();
+
+    int64_t sum = read_segment_sum(slots, 0, layout.segment_width, layout.row_size);
+    int64_t square_sum = read_segment_sum(slots, 1, layout.segment_width, layout.row_size);
+
+    double mean = (double)sum / total_elements;
+
+    // Second approach formula: (n*sum(x^2) - sum(x)^2)/n^2
+    double variance = ((long double)total_elements * square_sum - (long double)sum * sum) / pow(total_elements, 2);
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Count: " << total_elements << std::endl;
+    std::cout << "Sum: " << sum << std::endl;
+    std::cout << "Sum of squares: " << square_sum << std::endl;
+    std::cout << "Mean: " << mean << std::endl;
+    std::cout << "Variance: " << variance << std::endl;
+
+    printIntoCSV(processingTimes, total_time, mean, variance);
+}
@@ -0,0 +1,325 @@
+/**
+ * @file moments.cpp
+ * @author Bernardo Ramalho
+ * @brief FHE implementation of the first four moments (mean, variance, skewness and kurtosis) of n values using Slot Packing
+ * @version 0.1
+ * @date 2023-04-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "openfhe.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+#include "../../includes/auxiliaryFunctions.h"
+
+using namespace lbcrypto;
+
+void printIntoCSV(std::vector<double> processingTimes, double total_time, std::vector<double> moments){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream statisticsCSV("timeCSVs/statistics.csv", std::ios_base::app);
+    std::cout.rdbuf(statisticsCSV.rdbuf()); //redirect std::cout to out.txt!
+
+    std::cout << "\nmoments, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time;
+
+    for(unsigned int i = 0; i < moments.size(); i++){
+        std::cout << ", " << moments[i];
+    }
+    std::cout << std::endl;
+
+    statisticsCSV.close();
+}
+
+// sum(x), sum(x^2), sum(x^3) and sum(x^4), each in its own segment
+const int64_t number_powers = 4;
+
+/*
+ * Power sums of the values modulo plaintext_modulus, with a context and keys of their own.
+ * The times of each step are added into processingTimes[0] to processingTimes[3].
+ */
+std::vector<int64_t> calculatePowerSums(int64_t plaintext_modulus, const std::vector<int64_t>& all_numbers, std::vector<double>& processingTimes){
+    TimeVar t;
+
+    TIC(t);
+
+    // Set CryptoContext
+    // x^3 = x^2 * x and x^4 = x^2 * x^2, so the depth is 2
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(plaintext_modulus);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    // Each row is split in one segment per power
+    int64_t row_size = cryptoContext->GetRingDimension() / 2;
+    int64_t segment_width = row_size / number_powers;
+
+    // The rotate and sum only has to cover one segment
+    int64_t number_rotations = log2(segment_width);
+
+    // Key Generation
+
+    // Initialize Public Key Containers
+    KeyPair<DCRTPoly> keyPair;
+
+    // Generate a public/private key pair
+    keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys of the shared rotate and sum, plus the ones that move each power into its segment
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(number_rotations);
+    for(int64_t power = 1; power < number_powers; power++){
+        rotation_indexes.push_back(segment_rotation_index(power, segment_width, row_size));
+    }
+
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+    // Print time spent on setup
+    double setup_time = TOC(t);
+    processingTimes[0] += setup_time;
+
+    std::cout << "Duration of setup: " << setup_time << "ms" << std::endl;
+
+    TIC(t);
+
+    // Create Plaintexts
+    // The data is encrypted only once, with the values in the first segment of each row
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+    std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(all_numbers, segment_width, row_size);
+
+    for(unsigned int i = 0; i < packed_numbers.size(); i++){
+        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    }
+
+    // Print time spent on encryption
+    double encryption_time = TOC(t);
+    processingTimes[1] += encryption_time;
+
+    std::cout << "Duration of encryption: " << encryption_time << "ms" << std::endl;
+
+    TIC(t);
+
+    // Homomorphic Operations
+
+    // Calculate the powers of each chunk, reusing x^2 for both x^3 and x^4
+    // x^2 has to be relinearized since it is multiplied again, x^3 and x^4 are only relinearized after being added together
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> powerCiphertexts(number_powers);
+
+    for(unsigned int i = 0; i < ciphertexts.size(); i++){
+        auto squareCiphertext = cryptoContext->EvalSquare(ciphertexts[i]);
+
+        powerCiphertexts[0].push_back(ciphertexts[i]);
+        powerCiphertexts[1].push_back(squareCiphertext);
+        powerCiphertexts[2].push_back(cryptoContext->EvalMultNoRelin(squareCiphertext, ciphertexts[i]));
+        powerCiphertexts[3].push_back(cryptoContext->EvalMultNoRelin(squareCiphertext, squareCiphertext));
+    }
+
+    // Add the chunks of each power and move it into its own segment
+    auto resultCiphertext = cryptoContext->EvalAddMany(powerCiphertexts[0]);
+
+    for(int64_t power = 1; power < number_powers; power++){
+        auto powerSumCiphertext = cryptoContext->EvalAddMany(powerCiphertexts[power]);
+
+        if(power > 1){
+            powerSumCiphertext = cryptoContext->Relinearize(powerSumCiphertext);
+        }
+
+        powerSumCiphertext = cryptoContext->EvalRotate(powerSumCiphertext, segment_rotation_index(power, segment_width, row_size));
+        resultCiphertext = cryptoContext->EvalAdd(resultCiphertext, powerSumCiphertext);
+    }
+
+    // One rotate and sum reduces all the power sums at the same time
+    resultCiphertext = rotate_and_sum(cryptoContext, resultCiphertext, number_rotations);
+
+    // Print time spent on homomorphic operations
+    double operations_time = TOC(t);
+    processingTimes[2] += operations_time;
+
+    std::cout << "Duration of homomorphic operations: " << operations_time << "ms" << std::endl;
+
+    TIC(t);
+
+    // Decryption
+    // All the power sums come out of the same decryption
+    Plaintext plaintextDecAdd;
+
+    cryptoContext->Decrypt(keyPair.secretKey, resultCiphertext, &plaintextDecAdd);
+
+    std::vector<int64_t> slots = plaintextDecAdd->GetPackedValue();
+
+    // Each segment sum is only correct modulo the plaintext modulus, keep it in [0, t)
+    std::vector<int64_t> power_sums;
+    for(int64_t power = 0; power < number_powers; power++){
+        int64_t power_sum = read_segment_sum(slots, power, segment_width, row_size) % plaintext_modulus;
+        power_sums.push_back(power_sum < 0 ? power_sum + plaintext_modulus : power_sum);
+    }
+
+    // Print time spent on decryption
+    double decryption_time = TOC(t);
+    processingTimes[3] += decryption_time;
+
+    std::cout << "Duration of decryption: " << decryption_time << "ms" << std::endl;
+
+    return power_sums;
+}
+
+// value^-1 mod modulus, the modulus is prime
+int64_t inverse_modulo(int64_t value, int64_t modulus){
+    __int128 result = 1, base = value % modulus;
+
+    for(int64_t exponent = modulus - 2; exponent > 0; exponent /= 2){
+        if(exponent % 2 == 1){
+            result = result * base % modulus;
+        }
+        base = base * base % modulus;
+    }
+
+    return result;
+}
+
+/*
+ * Integer with the given residues modulo each of the moduli (Garner's algorithm), centered so that residues of a
+ * negative sum give back the negative value. The product of the moduli has to fit in a signed 128 bit integer.
+ */
+__int128 combine_residues(const std::vector<int64_t>& residues, const std::vector<int64_t>& moduli){
+    __int128 value = 0, product = 1;
+
+    for(unsigned int i = 0; i < moduli.size(); i++){
+        // Digit that makes value congruent with residues[i] without changing it modulo the previous moduli
+        __int128 difference = ((__int128)residues[i] - value % moduli[i] + moduli[i]) % moduli[i];
+        __int128 digit = difference * inverse_modulo(product % moduli[i], moduli[i]) % moduli[i];
+
+        value += digit * product;
+        product *= moduli[i];
+    }
+
+    return value > product / 2 ? value - product : value;
+}
+
+/*
+ * argv[1] --> number's file name
+*/
+int main(int argc, char *argv[]) {
+    // Read the vector from a file
+    std::ifstream numbers_file (argv[1]);
+
+     if (!numbers_file.is_open()) {
+        std::cerr << "Could not open the file - '"
+             << argv[1] << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Header of file contains information about nr of vector and the size of each of them
+    int64_t number_vectors, size_vectors, number;
+    std::vector<int64_t> all_numbers;
+
+    numbers_file >> number_vectors;
+    numbers_file >> size_vectors;
+
+    int64_t total_elements = size_vectors * number_vectors;
+
+    // Body of the file contains all the numbers
+    while (numbers_file >> number) {
+        all_numbers.push_back(number);
+    }
+
+    if(all_numbers.empty()){
+        std::cerr << "The file '" << argv[1] << "' has no numbers" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A power sum is only correct modulo the plaintext modulus, and sum(x^4) alone goes past 7000000462849 / 2
+    // from values of about 1370. Each power sum is computed under as many plaintext moduli as needed for the product
+    // of the moduli to be above 2 * n * max|x|^4 and the exact sums are recovered with the CRT.
+    // Both moduli are primes equal to 1 mod 2^15, so the slot packing works with ring dimensions up to 16384
+    const std::vector<int64_t> available_moduli = {7000000462849, 7000000561153};
+
+    long double max_absolute = 0;
+    for(unsigned int i = 0; i < all_numbers.size(); i++){
+        max_absolute = std::max(max_absolute, (long double)std::abs(all_numbers[i]));
+    }
+    long double bound = 2 * (long double)all_numbers.size() * pow(max_absolute, 4);
+
+    std::vector<int64_t> plaintext_moduli;
+    long double moduli_product = 1;
+    for(unsigned int i = 0; i < available_moduli.size() && moduli_product <= bound; i++){
+        plaintext_moduli.push_back(available_moduli[i]);
+        moduli_product *= available_moduli[i];
+    }
+
+    if(moduli_product <= bound){
+        std::cerr << "sum(x^4) of the values can be up to " << bound / 2 << ", more than the plaintext moduli can hold" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    // Setup, encryption, homomorphic operations and decryption under each plaintext modulus
+    std::vector<std::vector<int64_t>> residues;
+    for(unsigned int i = 0; i < plaintext_moduli.size(); i++){
+        residues.push_back(calculatePowerSums(plaintext_moduli[i], all_numbers, processingTimes));
+    }
+
+    TimeVar t;
+    TIC(t);
+
+    // Plaintext Operations
+
+    // Raw moments sum(x^k)/n
+    std::vector<long double> raw_moments;
+    for(int64_t power = 0; power < number_powers; power++){
+        std::vector<int64_t> power_residues;
+        for(unsigned int i = 0; i < plaintext_moduli.size(); i++){
+            power_residues.push_back(residues[i][power]);
+        }
+
+        raw_moments.push_back((long double)combine_residues(power_residues, plaintext_moduli) / total_elements);
+    }
+
+    // Central moments from the raw moments
+    long double mean = raw_moments[0];
+    long double second_moment = raw_moments[1] - mean * mean;
+    long double third_moment = raw_moments[2] - 3 * mean * raw_moments[1] + 2 * pow(mean, 3);
+    long double fourth_moment = raw_moments[3] - 4 * mean * raw_moments[2] + 6 * mean * mean * raw_moments[1] - 3 * pow(mean, 4);
+
+    double variance = second_moment;
+    double skewness = third_moment / pow(second_moment, 1.5);
+    double kurtosis = fourth_moment / (second_moment * second_moment);
+
+    // Print time spent on plaintext operations
+    TOC(t);
+    processingTimes[4] = TOC(t);
+
+    std::cout << "Duration of plaintext operations: " << processingTimes[4] << "ms" << std::endl;
+
+    // Calculate and print final time and value
+    double total_time = std::reduce(processingTimes.begin(), processingTimes.end());
+
+    std::cout << "Total runtime: " << total_time << "ms" << std::endl;
+    std::cout << "Mean: " << (double)mean << std::endl;
+    std::cout << "Variance: " << variance << std::endl;
+    std::cout << "Skewness: " << skewness << std::endl;
+    std::cout << "Kurtosis: " << kurtosis << std::endl;
+    std::cout << "Excess kurtosis: " << kurtosis - 3 << std::endl;
+
+    printIntoCSV(processingTimes, total_time, {(double)mean, variance, skewness, kurtosis});
+}
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <fstream>
 
+#include "../../includes/taskGraph.h"
+
 using namespace lbcrypto;
 
 Ciphertext<DCRTPoly> calculateSquareSum(CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair, std::vector<Ciphertext<DCRTPoly>> ciphertexts, std::vector<Plaintext> rotation_plaintexts,int64_t total_elements, int64_t number_rotations, int64_t size_vectors){
@@ -26,6 +28,7 @@ Ciphertext<DCRTPoly> calculateSquareSum(CryptoContext<DCRTPoly> cryptoContext, K
 
 /*
  * argv[1] --> number's file name
+ * argv[2] --> number of threads used to run the independent operations (optional)
 */
 int main(int argc, char *argv[]) {
     // Read the vector from a file
@@ -57,6 +60,9 @@ int main(int argc, char *argv[]) {
     // Due to the optimization we can do log(n) rotations
     double number_rotations = ceil(log2(size_vectors));
 
+    unsigned int number_threads = argc > 2 ? std::stoi(argv[2]) : default_number_threads();
+    ThreadPool pool(number_threads);
+
     TimeVar t;
     std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
 
@@ -157,20 +163,42 @@ int main(int argc, char *argv[]) {
     TIC(t);
 	    
     // Homomorphic Operations 
+    // Each operation is a node of the graph, so the square of the sum and the inner product run in parallel
+    TaskGraph<Ciphertext<DCRTPoly>> graph;
+
+    // The encrypted vectors are the inputs of the graph
+    std::vector<int> inputNodes;
+    for(unsigned int i = 0; i < ciphertexts.size(); i++){
+        inputNodes.push_back(graph.addInput(ciphertexts[i]));
+    }
+    int invertedInputNode = graph.addInput(inverted_ciphertexts[0]);
 
     // Calculate the Square Mean
-    auto negSquareSum = calculateSquareSum(cryptoContext, keyPair, ciphertexts, rotation_plaintexts,total_elements, number_rotations, size_vectors);
+    int squareSumNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return calculateSquareSum(cryptoContext, keyPair, inputs, rotation_plaintexts,total_elements, number_rotations, size_vectors);
+    }, inputNodes);
     
     // Calculate the Inner Product
     // Multiplying both vectors together will calculate the Inner Product value on the last index of the plaintext
-    Ciphertext<DCRTPoly> ciphertextInnerProduct = cryptoContext->EvalMult(ciphertexts[0], inverted_ciphertexts[0]);
+    int innerProductNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return cryptoContext->EvalMult(inputs[0], inputs[1]);
+    }, {inputNodes[0], invertedInputNode});
 
     std::vector<int64_t> totalVector(size_vectors, total_elements);
     Plaintext plaintextTotalElems = cryptoContext->MakeCoefPackedPlaintext(totalVector);
 
-    ciphertextInnerProduct = cryptoContext->EvalMult(ciphertextInnerProduct, plaintextTotalElems);
-        // Subtract the mean from the inner product
-    auto ciphertextResult = cryptoContext->EvalSub(ciphertextInnerProduct, negSquareSum);
+    int scaledInnerProductNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return cryptoContext->EvalMult(inputs[0], plaintextTotalElems);
+    }, {innerProductNode});
+
+    // Subtract the mean from the inner product, only runs after both branches are done
+    int resultNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return cryptoContext->EvalSub(inputs[0], inputs[1]);
+    }, {scaledInnerProductNode, squareSumNode});
+
+    graph.run(pool);
+
+    auto ciphertextResult = graph.getResult(resultNode);
 
     // Print time spent on homomorphic operations
     TOC(t);
@@ -2,8 +2,31 @@
 #include <iostream>
 #include <fstream>
 
+#include "../../includes/checkpoint.h"
+#include "../../includes/numberFileLoader.h"
+#include "../../includes/taskGraph.h"
+
 using namespace lbcrypto;
 
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double variance){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream varianceCSV("timeCSVs/variance.csv", std::ios_base::app);
+    std::cout.rdbuf(varianceCSV.rdbuf()); //redirect std::cout to out.txt!
+    
+    std::cout << "\ninner-product, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+    
+    std::cout << variance << std::endl;
+ 
+    varianceCSV.close();
+}
+
 Ciphertext<DCRTPoly> calculateSquareSum(CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair, std::vector<Ciphertext<DCRTPoly>> ciphertexts, int64_t number_rotations){
     auto ciphertextAdd = cryptoContext->EvalAddMany(ciphertexts);
 
@@ -34,70 +57,113 @@ Ciphertext<DCRTPoly> calculateInnerProduct(CryptoContext<DCRTPoly> cryptoContext
 
 /*
  * argv[1] --> number's file name
+ * argv[2] --> number of threads used to read the file and to run the independent operations (optional)
+ * argv[3] --> checkpoint directory (optional)
+ * argv[4] --> number of chunks between checkpoints (optional)
+ * argv[5] --> "resume" to continue from the last checkpoint in the directory (optional)
 */
 int main(int argc, char *argv[]) {
-    // Read the vector from a file
-    std::ifstream numbers_file (argv[1]);
+    unsigned int number_threads = argc > 2 ? std::stoi(argv[2]) : default_number_threads();
+    std::string checkpoint_directory = argc > 3 ? argv[3] : "";
+    int64_t checkpoint_interval = argc > 4 ? std::stoll(argv[4]) : 100;
+    bool resume = argc > 5 && std::string(argv[5]) == "resume";
 
-     if (!numbers_file.is_open()) {
-        std::cerr << "Could not open the file - '"
-             << argv[1] << "'" << std::endl;
+    if(checkpoint_interval <= 0){
+        std::cerr << "The number of chunks between checkpoints must be positive" << std::endl;
         return EXIT_FAILURE;
     }
 
+    // Read the vectors from the file
     // Header of file contains information about nr of vector and the size of each of them
-    int64_t number_vectors, size_vectors, number;
-    std::vector<int64_t> all_numbers;
+    NumberFile numbers_file;
 
-    numbers_file >> number_vectors;
-    numbers_file >> size_vectors;
+    try{
+        numbers_file = load_number_file(argv[1], number_threads);
+    }
+    catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int64_t number_vectors = numbers_file.number_vectors;
+    int64_t size_vectors = numbers_file.size_vectors;
 
     int64_t total_elements = size_vectors * number_vectors;
 
-    // Body of the file contains all the numbers
-    while (numbers_file >> number) {
-        all_numbers.push_back(number);
-    }
+    std::cout << "Duration of reading: " << numbers_file.milliseconds << "ms (" << numbers_file.gigabytes_per_second() << " GB/s)" << std::endl;
 
     // Due to the optimization we can do log(n) - 1 rotations
     double number_rotations = ceil(log2(size_vectors));
 
+    ThreadPool pool(number_threads);
+
     TimeVar t;
     std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
 
     TIC(t);
 
-    // Set CryptoContext
-    CCParams<CryptoContextBFVRNS> parameters;
-    parameters.SetPlaintextModulus(7000000462849);
-    parameters.SetMultiplicativeDepth(2);
-
-    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
-    // Enable features that you wish to use
-    cryptoContext->Enable(PKE);
-    cryptoContext->Enable(KEYSWITCH);
-    cryptoContext->Enable(LEVELEDSHE);
-    cryptoContext->Enable(ADVANCEDSHE);
-
-    // Key Generation
-
-    // Initialize Public Key Containers
+    CryptoContext<DCRTPoly> cryptoContext;
     KeyPair<DCRTPoly> keyPair;
-
-    // Generate a public/private key pair
-    keyPair = cryptoContext->KeyGen();
-
-    // Generate the relinearization key
-    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+    CheckpointState checkpoint;
+    std::string checkpoint_input_id = checkpoint_directory.empty() ? "" : checkpoint_input(argv[1]);
+
+    if(resume){
+        // The accumulators of the checkpoint are encrypted under its keys, so they are loaded instead of generated
+        try{
+            cryptoContext = load_evaluation_context(checkpoint_directory);
+            keyPair.publicKey = load_public_key(checkpoint_directory);
+            keyPair.secretKey = load_secret_key(checkpoint_directory);
+
+            checkpoint = load_checkpoint(checkpoint_directory, cryptoContext, keyPair.publicKey, "inner-product-variance", checkpoint_input_id, 2);
+        }
+        catch(const std::exception& e){
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "Resuming from chunk " << checkpoint.next_chunk << " of " << number_vectors << std::endl;
+    }
+    else{
+        // Set CryptoContext
+        CCParams<CryptoContextBFVRNS> parameters;
+        parameters.SetPlaintextModulus(7000000462849);
+        parameters.SetMultiplicativeDepth(2);
+
+        cryptoContext = GenCryptoContext(parameters);
+        // Enable features that you wish to use
+        cryptoContext->Enable(PKE);
+        cryptoContext->Enable(KEYSWITCH);
+        cryptoContext->Enable(LEVELEDSHE);
+        cryptoContext->Enable(ADVANCEDSHE);
+
+        // Key Generation
+
+        // Generate a public/private key pair
+        keyPair = cryptoContext->KeyGen();
+
+        // Generate the relinearization key
+        cryptoContext->EvalMultKeyGen(keyPair.secretKey);
     
-    // Generate the rotation evaluation keys
-    std::vector<int32_t> rotation_indexes;
-    for(int i = 0; i < number_rotations; i++){
-       rotation_indexes.push_back(pow(2,i)); // Rotate always in 2^i
+        // Generate the rotation evaluation keys
+        std::vector<int32_t> rotation_indexes;
+        for(int i = 0; i < number_rotations; i++){
+           rotation_indexes.push_back(pow(2,i)); // Rotate always in 2^i
+        }
+
+        cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);
+
+        // An unwritable checkpoint directory is reported before any work is done, like a failed resume
+        if(!checkpoint_directory.empty()){
+            try{
+                start_checkpoints(checkpoint_directory, cryptoContext, keyPair);
+            }
+            catch(const std::exception& e){
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
     }
 
-    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, rotation_indexes);    
-    
     // Print time spent on setup
     TOC(t);
     processingTimes[0] = TOC(t);
@@ -109,18 +175,59 @@ int main(int argc, char *argv[]) {
     // Create Plaintexts
     std::vector<Ciphertext<DCRTPoly>> ciphertexts;
     
-    int begin, end;
-    
-    for(int i = 0; i < number_vectors; i++){
-        // Calculate beginning and end of plaintext values
-        begin = i * size_vectors;
-        end = size_vectors * (i + 1);
-
-        // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
-        Plaintext plaintext = cryptoContext->MakePackedPlaintext(std::vector<int64_t>(all_numbers.begin() + begin, all_numbers.begin() + end));
-        ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+    // Ciphertexts added together for the square of the sum, the inner product only uses the first one
+    std::vector<Ciphertext<DCRTPoly>> sumCiphertexts;
+
+    if(checkpoint_directory.empty()){
+        for(int i = 0; i < number_vectors; i++){
+            // Encode Plaintext with slot packing and encrypt it into a ciphertext vector
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(numbers_file.vectors[i]);
+            ciphertexts.push_back(cryptoContext->Encrypt(keyPair.publicKey, plaintext));
+        }
+
+        sumCiphertexts = ciphertexts;
     }
-    
+    else{
+        // Each chunk is added into the sum as soon as it is encrypted. The sum, the first ciphertext and the number
+        // of chunks done are all that is needed to continue, they are saved every checkpoint_interval chunks
+        Ciphertext<DCRTPoly> sum = checkpoint.accumulators.empty() ? nullptr : checkpoint.accumulators[0];
+        Ciphertext<DCRTPoly> first = checkpoint.accumulators.empty() ? nullptr : checkpoint.accumulators[1];
+        double checkpoint_time = 0;
+        int number_checkpoints = 0;
+
+        for(int64_t i = checkpoint.next_chunk; i < number_vectors; i++){
+            Plaintext plaintext = cryptoContext->MakePackedPlaintext(numbers_file.vectors[i]);
+            Ciphertext<DCRTPoly> ciphertext = cryptoContext->Encrypt(keyPair.publicKey, plaintext);
+
+            sum = sum ? cryptoContext->EvalAdd(sum, ciphertext) : ciphertext;
+            first = first ? first : ciphertext;
+
+            if((i + 1) % checkpoint_interval == 0 && i + 1 < number_vectors){
+                TimeVar checkpoint_timer;
+                TIC(checkpoint_timer);
+
+                checkpoint.next_chunk = i + 1;
+                checkpoint.accumulators = {sum, first};
+
+                // A failed checkpoint only means a later crash restarts from an older one
+                try{
+                    save_checkpoint(checkpoint_directory, cryptoContext, keyPair.publicKey, "inner-product-variance", checkpoint_input_id, checkpoint);
+                    number_checkpoints++;
+                }
+                catch(const std::exception& e){
+                    std::cerr << "Checkpoint failed: " << e.what() << std::endl;
+                }
+
+                checkpoint_time += TOC(checkpoint_timer);
+            }
+        }
+
+        std::cout << "Checkpoints: " << number_checkpoints << " (" << checkpoint_time << "ms)" << std::endl;
+
+        ciphertexts.push_back(first);
+        sumCiphertexts.push_back(sum);
+    }
+
     // Print time spent on encryption
     TOC(t);
     processingTimes[1] = TOC(t);
@@ -130,19 +237,40 @@ int main(int argc, char *argv[]) {
     TIC(t);
 	    
     // Homomorphic Operations 
+    // Each operation is a node of the graph, so the square of the sum and the inner product run in parallel
+    TaskGraph<Ciphertext<DCRTPoly>> graph;
+
+    // The encrypted vectors are the inputs of the graph
+    std::vector<int> sumInputNodes;
+    for(unsigned int i = 0; i < sumCiphertexts.size(); i++){
+        sumInputNodes.push_back(graph.addInput(sumCiphertexts[i]));
+    }
+    int firstInputNode = graph.addInput(ciphertexts[0]);
 
     // Calculate the Sum
-    Ciphertext<DCRTPoly> sumCiphertext = calculateSquareSum(cryptoContext, keyPair, ciphertexts, number_rotations);
+    int sumNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return calculateSquareSum(cryptoContext, keyPair, inputs, number_rotations);
+    }, sumInputNodes);
     
     // Calculate the Inner Product
-    Ciphertext<DCRTPoly> innerProductCiphertext = calculateInnerProduct(cryptoContext, keyPair, ciphertexts, number_rotations);
+    int innerProductNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return calculateInnerProduct(cryptoContext, keyPair, inputs, number_rotations);
+    }, {firstInputNode});
 
     // Create Plaintext to multiply with inner product
     Plaintext nPlaintext = cryptoContext->MakePackedPlaintext({total_elements});
-    innerProductCiphertext = cryptoContext->EvalMult(innerProductCiphertext, nPlaintext);
+    int scaledInnerProductNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return cryptoContext->EvalMult(inputs[0], nPlaintext);
+    }, {innerProductNode});
+
+    // Subtract the Sum from the Inner Product, only runs after both branches are done
+    int resultNode = graph.addNode([&](const std::vector<Ciphertext<DCRTPoly>>& inputs){
+        return cryptoContext->EvalSub(inputs[0], inputs[1]);
+    }, {scaledInnerProductNode, sumNode});
 
-    // Subtract the Sum from the Inner Product
-    auto resultCiphertext = cryptoContext->EvalSub(innerProductCiphertext, sumCiphertext);
+    graph.run(pool);
+
+    auto resultCiphertext = graph.getResult(resultNode);
 
     // Print time spent on homomorphic operations
     TOC(t);
@@ -180,4 +308,6 @@ int main(int argc, char *argv[]) {
 
     std::cout << "Total runtime: " << total_time << "ms" << std::endl;
     std::cout << "Variance: " << variance << std::endl;
+
+    printIntoCSV(processingTimes, total_time, variance);
 }
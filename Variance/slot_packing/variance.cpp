@@ -2,8 +2,29 @@
 #include <iostream>
 #include <fstream>
 
+#include "../../includes/parallelMapReduce.h"
+
 using namespace lbcrypto;
 
+void printIntoCSV(std::vector<double> processingTimes, double total_time, double variance){
+    // Open the file
+    std::string filePath;
+
+    std::ofstream varianceCSV("timeCSVs/variance.csv", std::ios_base::app);
+    std::cout.rdbuf(varianceCSV.rdbuf()); //redirect std::cout to out.txt!
+    
+    std::cout << "\nfirst-approach, ";
+
+    for(unsigned int i = 0; i < processingTimes.size(); i++){
+        std::cout << processingTimes[i] << ", ";
+    }
+    std::cout << total_time << ", ";
+    
+    std::cout << variance << std::endl;
+ 
+    varianceCSV.close();
+}
+
 Ciphertext<DCRTPoly> calculateSum(CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair, std::vector<Ciphertext<DCRTPoly>> ciphertexts, int64_t number_rotations, int64_t size_vectors){
     auto ciphertextAdd = cryptoContext->EvalAddMany(ciphertexts);
 
@@ -19,6 +40,7 @@ Ciphertext<DCRTPoly> calculateSum(CryptoContext<DCRTPoly> cryptoContext, KeyPair
 
 /*
  * argv[1] --> number's file name
+ * argv[2] --> number of threads used to transform and add the ciphertexts (optional)
 */
 int main(int argc, char *argv[]) {
     // Read the vector from a file
@@ -47,6 +69,9 @@ int main(int argc, char *argv[]) {
     // Due to the optimization we can do log(n) - 1 rotations
     double number_rotations = ceil(log2(size_vectors));
 
+    unsigned int number_threads = argc > 2 ? std::stoi(argv[2]) : default_number_threads();
+    ThreadPool pool(number_threads);
+
     TimeVar t;
     std::vector<double> processingTimes = {0.0, 0.0, 0.0, 0.0, 0.0};
 
@@ -123,22 +148,25 @@ int main(int argc, char *argv[]) {
     Plaintext plaintextTotalElems = cryptoContext->MakePackedPlaintext(totalVector);
     std::cout << "Lenght of array: " << totalVector.size();
 
-    std::vector<Ciphertext<DCRTPoly>> subCiphertexts;
-
-    for(int i = 0; i < (int)ciphertexts.size(); i++){
+    // Each ciphertext is transformed independently, so the chunks are split between the threads
+    // and every transformed chunk is added straight into the accumulator of its thread
+    auto squareChunk = [&](const Ciphertext<DCRTPoly>& ciphertext){
         // Calculate n*xi
-        auto ciphertextMul = cryptoContext->EvalMult(ciphertexts[i], plaintextTotalElems);
+        auto ciphertextMul = cryptoContext->EvalMult(ciphertext, plaintextTotalElems);
 
         // Calculate n*xi - sum(x)
         auto ciphertextSub = cryptoContext->EvalSub(ciphertextMul, negSumCiphertext);
 
-       
         // Square Everything
-        subCiphertexts.push_back(cryptoContext->EvalSquare(ciphertextSub));
-    }
+        return cryptoContext->EvalSquare(ciphertextSub);
+    };
+
+    auto addChunks = [&](const Ciphertext<DCRTPoly>& left, const Ciphertext<DCRTPoly>& right){
+        return cryptoContext->EvalAdd(left, right);
+    };
 
     // Calculate sum((xi - mean)^2)
-    auto ciphertextAdd = cryptoContext->EvalAddMany(subCiphertexts);
+    auto ciphertextAdd = parallel_map_reduce(ciphertexts, squareChunk, addChunks, pool);
 
     auto ciphertextRot = ciphertextAdd;
 
@@ -183,4 +211,6 @@ int main(int argc, char *argv[]) {
 
     std::cout << "Total runtime: " << total_time << "ms" << std::endl;
     std::cout << "Variance: " << variance << std::endl;
+
+    printIntoCSV(processingTimes, total_time, variance);
 }
@@ -36,3 +36,164 @@ std::vector<Plaintext> generate_rotation_plaintexts(int64_t number_rotations, Cr
 
     return rotation_plaintexts;
 }
+
+std::vector<int32_t> generate_rotation_indexes(int64_t number_rotations){
+    std::vector<int32_t> rotation_indexes;
+
+    for(int i = 0; i < number_rotations; i++){
+        rotation_indexes.push_back(pow(2, i)); // Rotate always in 2^i
+    }
+
+    return rotation_indexes;
+}
+
+Ciphertext<DCRTPoly> rotate_and_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t number_rotations){
+    auto ciphertextRot = ciphertext;
+
+    for(int i = 0; i < number_rotations; i++){
+        ciphertextRot = cryptoContext->EvalRotate(ciphertext, pow(2, i));
+
+        ciphertext = cryptoContext->EvalAdd(ciphertext, ciphertextRot);
+    }
+
+    return ciphertext;
+}
+
+std::vector<int32_t> generate_scan_rotation_indexes(int64_t number_steps){
+    std::vector<int32_t> rotation_indexes;
+
+    for(int i = 0; i < number_steps; i++){
+        rotation_indexes.push_back(-pow(2, i)); // Negative indexes rotate to the right
+    }
+
+    return rotation_indexes;
+}
+
+Ciphertext<DCRTPoly> inclusive_scan(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t number_steps){
+    auto ciphertextRot = ciphertext;
+
+    for(int i = 0; i < number_steps; i++){
+        // Slot j receives slot j - 2^i, the first 2^i slots receive zeros from the empty end of the row
+        ciphertextRot = cryptoContext->EvalRotate(ciphertext, -pow(2, i));
+
+        ciphertext = cryptoContext->EvalAdd(ciphertext, ciphertextRot);
+    }
+
+    return ciphertext;
+}
+
+std::vector<Ciphertext<DCRTPoly>> inclusive_scan_chunks(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& chunks, int64_t number_steps){
+    int64_t row_rotations = log2(cryptoContext->GetRingDimension() / 2);
+
+    std::vector<Ciphertext<DCRTPoly>> scans;
+    Ciphertext<DCRTPoly> carry;
+
+    for(size_t c = 0; c < chunks.size(); c++){
+        auto scan = inclusive_scan(cryptoContext, chunks[c], number_steps);
+
+        if(carry){
+            scan = cryptoContext->EvalAdd(scan, carry);
+        }
+        scans.push_back(scan);
+
+        // Summing the whole row leaves the total of the chunk in every slot of the first row
+        if(c + 1 < chunks.size()){
+            auto total = rotate_and_sum(cryptoContext, chunks[c], row_rotations);
+
+            carry = carry ? cryptoContext->EvalAdd(carry, total) : total;
+        }
+    }
+
+    return scans;
+}
+
+std::vector<int32_t> moving_window_rotation_indexes(int64_t window){
+    std::vector<int32_t> rotation_indexes;
+    int64_t offset = 0;
+
+    for(int64_t block = 1; block <= window; block *= 2){
+        // The block of 2^k slots is added at the current offset, when the bit is set
+        if((window & block) && offset > 0){
+            rotation_indexes.push_back(offset);
+        }
+        if(window & block){
+            offset += block;
+        }
+
+        // Doubling the block, only while there are bits left
+        if(block * 2 <= window){
+            rotation_indexes.push_back(block);
+        }
+    }
+
+    // The doubling and the offsets can share rotations
+    std::sort(rotation_indexes.begin(), rotation_indexes.end());
+    rotation_indexes.erase(std::unique(rotation_indexes.begin(), rotation_indexes.end()), rotation_indexes.end());
+
+    return rotation_indexes;
+}
+
+Ciphertext<DCRTPoly> moving_window_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t window){
+    // blockSum holds, in slot j, the sum of slots j to j + block - 1
+    auto blockSum = ciphertext;
+    Ciphertext<DCRTPoly> windowSum;
+    int64_t offset = 0;
+
+    for(int64_t block = 1; block <= window; block *= 2){
+        if(window & block){
+            auto shiftedSum = offset > 0 ? cryptoContext->EvalRotate(blockSum, offset) : blockSum;
+
+            windowSum = windowSum ? cryptoContext->EvalAdd(windowSum, shiftedSum) : shiftedSum;
+            offset += block;
+        }
+
+        if(block * 2 <= window){
+            blockSum = cryptoContext->EvalAdd(blockSum, cryptoContext->EvalRotate(blockSum, block));
+        }
+    }
+
+    return windowSum;
+}
+
+std::vector<std::vector<int64_t>> pack_first_segment(const std::vector<int64_t>& values, int64_t segment_width, int64_t row_size){
+    std::vector<std::vector<int64_t>> packed_values;
+
+    // Each slot vector holds one segment of values in each row
+    for(size_t begin = 0; begin < values.size(); begin += 2 * segment_width){
+        std::vector<int64_t> slots(2 * row_size, 0);
+
+        for(int64_t i = 0; i < 2 * segment_width && begin + i < values.size(); i++){
+            // First half goes into the first row, second half into the second row
+            int64_t slot = i < segment_width ? i : row_size + i - segment_width;
+
+            slots[slot] = values[begin + i];
+        }
+
+        packed_values.push_back(slots);
+    }
+
+    return packed_values;
+}
+
+int32_t segment_rotation_index(int64_t segment, int64_t segment_width, int64_t row_size){
+    // Rotating left by row_size - k * segment_width is the same as rotating right by k * segment_width
+    return row_size - segment * segment_width;
+}
+
+int64_t read_segment_sum(const std::vector<int64_t>& slots, int64_t segment, int64_t segment_width, int64_t row_size){
+    return slots[segment * segment_width] + slots[row_size + segment * segment_width];
+}
+
+double percentile(std::vector<double> values, double fraction){
+    if(values.empty()){
+        return 0;
+    }
+
+    // Nearest rank
+    size_t rank = ceil(fraction * values.size());
+    rank = rank == 0 ? 0 : rank - 1;
+
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+
+    return values[rank];
+}
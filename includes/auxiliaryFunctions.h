@@ -1,3 +1,6 @@
+#ifndef AUXILIARY_FUNCTIONS_H
+#define AUXILIARY_FUNCTIONS_H
+
 #include "openfhe.h"
 
 using namespace lbcrypto;
@@ -7,3 +10,50 @@ std::vector<int64_t> pre_process_numbers(std::vector<int64_t> values, int64_t al
 std::vector<int64_t> post_process_numbers(std::vector<int64_t> pre_processed_values, int64_t alpha, int64_t plaintext_modulus);
 
 std::vector<Plaintext> generate_rotation_plaintexts(int64_t number_rotations, CryptoContext<DCRTPoly> cryptoContext);
+
+// Rotation indexes 2^i, for i = 0 to i < number_rotations, used by rotate_and_sum
+std::vector<int32_t> generate_rotation_indexes(int64_t number_rotations);
+
+// Rotate by 2^i and add, number_rotations times. Slot j ends with the sum of slots j to j + 2^number_rotations - 1 of its row
+Ciphertext<DCRTPoly> rotate_and_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t number_rotations);
+
+// Rotation indexes -2^i (right rotations), for i = 0 to i < number_steps, used by inclusive_scan
+std::vector<int32_t> generate_scan_rotation_indexes(int64_t number_steps);
+
+// Hillis-Steele scan: rotate right by 2^i and add, number_steps times. Slot j of the first row ends with the sum of slots 0 to j,
+// for the first 2^number_steps slots. The values have to be in the first half of the first row, with zeros everywhere else:
+// the zeros act as the mask of the scan, since the slots that wrap around from the end of the row are always zero
+Ciphertext<DCRTPoly> inclusive_scan(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t number_steps);
+
+// inclusive_scan of consecutive chunks, each one with its values packed as inclusive_scan expects.
+// The total of all the previous chunks (a full row rotate_and_sum, so it also needs generate_rotation_indexes(log2(row_size)))
+// is carried into every slot of each chunk
+std::vector<Ciphertext<DCRTPoly>> inclusive_scan_chunks(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& chunks, int64_t number_steps);
+
+// Rotation indexes needed by moving_window_sum for the given window
+std::vector<int32_t> moving_window_rotation_indexes(int64_t window);
+
+// Slot j ends with the sum of slots j to j + window - 1 of its row, for any window (not only powers of 2).
+// Sums of 2^k slots are built by doubling and the ones matching the bits of the window are added at their offset,
+// so it takes at most 2*log2(window) rotations. Slots closer than window to the end of the row wrap around
+Ciphertext<DCRTPoly> moving_window_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> ciphertext, int64_t window);
+
+/*
+ * Segment packing: each row of slots (ring dimension / 2 slots) is split into segments of segment_width slots.
+ * The values are packed only in the first segment of both rows, so different results can be moved into
+ * different segments of the same ciphertext and all of them summed by one rotate_and_sum of log2(segment_width) rotations.
+ */
+
+// Split the values into slot vectors (of 2 * row_size slots) where only the first segment of each row holds values
+std::vector<std::vector<int64_t>> pack_first_segment(const std::vector<int64_t>& values, int64_t segment_width, int64_t row_size);
+
+// Rotation index that moves the first segment into the given segment
+int32_t segment_rotation_index(int64_t segment, int64_t segment_width, int64_t row_size);
+
+// After rotate_and_sum, the sum of a segment is split between its first slot in both rows
+int64_t read_segment_sum(const std::vector<int64_t>& slots, int64_t segment, int64_t segment_width, int64_t row_size);
+
+// Value below which the given fraction (0 to 1) of the values fall, e.g. 0.99 for the p99 latency
+double percentile(std::vector<double> values, double fraction);
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Bounded lock-free multi-producer multi-consumer queue (Dmitry Vyukov's algorithm).
+ *
+ * Each cell has a sequence number that says whose turn it is: a producer can write the cell at position p
+ * when its sequence is p, and a consumer can read it when its sequence is p + 1. Producers and consumers only
+ * compete on their own position counter with a compare-and-swap, so a push and a pop never wait on each other.
+ *
+ * try_push and try_pop never block, they return false when the queue is full or empty.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    // The capacity is rounded up to a power of 2
+    explicit BoundedQueue(size_t capacity){
+        size_t size = 2;
+        while(size < capacity){
+            size *= 2;
+        }
+
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+
+        for(size_t i = 0; i < size; i++){
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // The value is only moved from when the push succeeds
+    bool try_push(T& value){
+        Cell* cell;
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+
+        while(true){
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+            if(difference == 0){
+                if(enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            }
+            else if(difference < 0){
+                // The consumers have not read this cell yet: full
+                return false;
+            }
+            else{
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool try_pop(T& value){
+        Cell* cell;
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+
+        while(true){
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+            if(difference == 0){
+                if(dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            }
+            else if(difference < 0){
+                // No producer has written this cell yet: empty
+                return false;
+            }
+            else{
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->value);
+
+        // The cell is free again for the producer one lap later
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Number of values in the queue, only approximate while other threads push or pop
+    size_t size() const {
+        size_t enqueued = enqueue_position.load(std::memory_order_relaxed);
+        size_t dequeued = dequeue_position.load(std::memory_order_relaxed);
+
+        return enqueued > dequeued ? std::min(enqueued - dequeued, capacity()) : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // On different cache lines, so producers and consumers do not invalidate each other's counter
+    alignas(64) std::atomic<size_t> enqueue_position{0};
+    alignas(64) std::atomic<size_t> dequeue_position{0};
+};
+
+#endif
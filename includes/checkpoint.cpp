@@ -0,0 +1,88 @@
+#include "checkpoint.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <sys/stat.h>
+
+static std::string checkpoint_file(const std::string& directory){
+    return directory + "/checkpoint.bin";
+}
+
+void start_checkpoints(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair){
+    if(mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST){
+        throw std::runtime_error("Could not create the checkpoint directory '" + directory + "'");
+    }
+
+    // An old checkpoint is encrypted under other keys, so it can not be resumed after the new keys are saved
+    std::remove(checkpoint_file(directory).c_str());
+
+    save_keys(directory, cryptoContext, keyPair);
+}
+
+std::string checkpoint_input(const std::string& path){
+    struct stat file_stat;
+    if(stat(path.c_str(), &file_stat) != 0){
+        throw std::runtime_error("Could not read the file - '" + path + "'");
+    }
+
+    return path + ":" + std::to_string(file_stat.st_size) + ":" + std::to_string(file_stat.st_mtime);
+}
+
+uint64_t save_checkpoint(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                         const std::string& program, const std::string& input, const CheckpointState& state){
+    ContainerMetadata metadata;
+    metadata["type"] = "checkpoint";
+    metadata["program"] = program;
+    metadata["accumulators"] = std::to_string(state.accumulators.size());
+    metadata["fingerprint"] = context_fingerprint(cryptoContext, publicKey);
+    metadata["input"] = input;
+    metadata["next_chunk"] = std::to_string(state.next_chunk);
+
+    std::string path = checkpoint_file(directory);
+    std::string temporary_path = path + ".tmp";
+
+    ContainerWriter writer(temporary_path, metadata, state.accumulators.size());
+    for(size_t i = 0; i < state.accumulators.size(); i++){
+        writer.add(state.accumulators[i]);
+    }
+    uint64_t bytes = writer.finish();
+
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+        throw std::runtime_error("Could not replace '" + path + "'");
+    }
+
+    return bytes;
+}
+
+CheckpointState load_checkpoint(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                                const std::string& program, const std::string& input, size_t number_accumulators){
+    std::string path = checkpoint_file(directory);
+    CiphertextContainer container(path);
+
+    if(container.getMetadata("type") != "checkpoint"){
+        throw std::runtime_error("'" + path + "' is not a checkpoint");
+    }
+
+    if(container.getMetadata("program") != program){
+        throw std::runtime_error("The checkpoint '" + path + "' was made by another program (" + container.getMetadata("program") + ")");
+    }
+
+    if(container.getMetadata("accumulators") != std::to_string(number_accumulators) || container.size() != number_accumulators){
+        throw std::runtime_error("The checkpoint '" + path + "' does not have " + std::to_string(number_accumulators) + " accumulators");
+    }
+
+    if(container.getMetadata("fingerprint") != context_fingerprint(cryptoContext, publicKey)){
+        throw std::runtime_error("The checkpoint '" + path + "' was made with other keys");
+    }
+
+    if(container.getMetadata("input") != input){
+        throw std::runtime_error("The checkpoint '" + path + "' was made over another input (" + container.getMetadata("input") + ")");
+    }
+
+    CheckpointState state;
+    state.next_chunk = std::stoll(container.getMetadata("next_chunk"));
+    state.accumulators = container.getAll();
+
+    return state;
+}
@@ -0,0 +1,42 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "ciphertextContainer.h"
+
+/*
+ * Checkpoints of long running aggregations: the partial accumulator ciphertexts and the number of chunks
+ * already added into them, so a run that crashes can continue from the last checkpoint instead of the start.
+ *
+ * Checkpoint directory:
+ *   - the context and the keys (the same files as save_keys), written once when the run starts. The accumulators
+ *     are encrypted under those keys, so a resumed run has to load them instead of generating new ones.
+ *   - checkpoint.bin, a ciphertext container with the accumulators as entries and in the metadata the program that
+ *     wrote it, the number of accumulators, the context fingerprint, the input file (path, size and modification time)
+ *     and the next chunk to process.
+ *
+ * checkpoint.bin is written next to the old one and renamed over it, so a crash while saving keeps the previous checkpoint.
+ */
+
+struct CheckpointState {
+    // Chunks 0 to next_chunk - 1 are already in the accumulators
+    int64_t next_chunk = 0;
+    std::vector<Ciphertext<DCRTPoly>> accumulators;
+};
+
+// Create the directory and save the context and the keys the accumulators will be encrypted with
+void start_checkpoints(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair);
+
+// Identifies the input file, so a checkpoint is not resumed over a different or changed file
+std::string checkpoint_input(const std::string& path);
+
+// program names the aggregation, so another program never resumes from this checkpoint. Returns the size of checkpoint.bin in bytes
+uint64_t save_checkpoint(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                         const std::string& program, const std::string& input, const CheckpointState& state);
+
+// Load checkpoint.bin, the context and keys must be the ones loaded from the same directory.
+// Throws std::runtime_error if there is no checkpoint, it belongs to other keys, another program or another input,
+// or it does not hold number_accumulators accumulators
+CheckpointState load_checkpoint(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                                const std::string& program, const std::string& input, size_t number_accumulators);
+
+#endif
@@ -0,0 +1,225 @@
+#include "ciphertextContainer.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <streambuf>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char CONTAINER_MAGIC[4] = {'H', 'E', 'C', 'T'};
+static const uint32_t CONTAINER_VERSION = 1;
+
+// Read only stream buffer over memory that is owned by someone else, so nothing is copied
+class MemoryStreamBuffer : public std::streambuf {
+public:
+    MemoryStreamBuffer(const char* data, size_t size){
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode) override {
+        char* position = direction == std::ios_base::beg ? eback() : direction == std::ios_base::cur ? gptr() : egptr();
+        position += offset;
+
+        if(position < eback() || position > egptr()){
+            return pos_type(off_type(-1));
+        }
+
+        setg(eback(), position, egptr());
+        return pos_type(position - eback());
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode mode) override {
+        return seekoff(off_type(position), std::ios_base::beg, mode);
+    }
+};
+
+// Little endian integer of number_bytes bytes (4 for the version, 8 for everything else)
+static void write_uint(std::ostream& stream, uint64_t value, int number_bytes){
+    char bytes[8];
+    for(int i = 0; i < number_bytes; i++){
+        bytes[i] = (char)((value >> (8 * i)) & 0xff);
+    }
+    stream.write(bytes, number_bytes);
+}
+
+static uint64_t read_uint(const char* data, size_t size, size_t& position, int number_bytes){
+    if(size < (size_t)number_bytes || position > size - number_bytes){
+        throw std::runtime_error("Truncated ciphertext container");
+    }
+
+    uint64_t value = 0;
+    for(int i = 0; i < number_bytes; i++){
+        value |= (uint64_t)(unsigned char)data[position + i] << (8 * i);
+    }
+    position += number_bytes;
+
+    return value;
+}
+
+static void write_u64(std::ostream& stream, uint64_t value){
+    write_uint(stream, value, 8);
+}
+
+static uint64_t read_u64(const char* data, size_t size, size_t& position){
+    return read_uint(data, size, position, 8);
+}
+
+ContainerWriter::ContainerWriter(const std::string& path, const ContainerMetadata& metadata, uint64_t number_entries)
+    : path(path), file(path, std::ios::out | std::ios::binary | std::ios::trunc), number_entries(number_entries){
+    if(!file.is_open()){
+        throw std::runtime_error("Could not create the container '" + path + "'");
+    }
+
+    std::string encoded_metadata;
+    for(auto it = metadata.begin(); it != metadata.end(); it++){
+        encoded_metadata += it->first + "=" + it->second + "\n";
+    }
+
+    file.write(CONTAINER_MAGIC, 4);
+    write_uint(file, CONTAINER_VERSION, 4);
+    write_u64(file, number_entries);
+    write_u64(file, encoded_metadata.size());
+    file.write(encoded_metadata.data(), encoded_metadata.size());
+
+    // The table is only known at the end, so leave room for it
+    table_position = file.tellp();
+    for(uint64_t i = 0; i < 2 * number_entries; i++){
+        write_u64(file, 0);
+    }
+}
+
+void ContainerWriter::add(ConstCiphertext<DCRTPoly> ciphertext){
+    if(offsets.size() == number_entries){
+        throw std::runtime_error("Too many entries for the container '" + path + "'");
+    }
+
+    uint64_t begin = file.tellp();
+    Serial::Serialize(ciphertext, file, SerType::BINARY);
+    uint64_t end = file.tellp();
+
+    offsets.push_back(begin);
+    sizes.push_back(end - begin);
+}
+
+uint64_t ContainerWriter::finish(){
+    if(offsets.size() != number_entries){
+        throw std::runtime_error("Missing entries in the container '" + path + "'");
+    }
+
+    uint64_t total_size = file.tellp();
+
+    file.seekp(table_position);
+    for(uint64_t i = 0; i < number_entries; i++){
+        write_u64(file, offsets[i]);
+        write_u64(file, sizes[i]);
+    }
+
+    file.close();
+    if(file.fail()){
+        throw std::runtime_error("Could not write the container '" + path + "'");
+    }
+
+    return total_size;
+}
+
+CiphertextContainer::CiphertextContainer(const std::string& path){
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("Could not open the container '" + path + "'");
+    }
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) < 0 || file_stat.st_size == 0){
+        close(fd);
+        throw std::runtime_error("Could not read the container '" + path + "'");
+    }
+
+    mapped_size = file_stat.st_size;
+    void* data = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED){
+        throw std::runtime_error("Could not map the container '" + path + "'");
+    }
+    mapped_data = (const char*)data;
+
+    try{
+        if(mapped_size < 8 || std::memcmp(mapped_data, CONTAINER_MAGIC, 4) != 0){
+            throw std::runtime_error("'" + path + "' is not a ciphertext container");
+        }
+
+        size_t position = 4;
+        uint64_t version = read_uint(mapped_data, mapped_size, position, 4);
+        if(version != CONTAINER_VERSION){
+            throw std::runtime_error("Unsupported container version in '" + path + "'");
+        }
+
+        uint64_t number_entries = read_u64(mapped_data, mapped_size, position);
+        uint64_t metadata_size = read_u64(mapped_data, mapped_size, position);
+
+        if(metadata_size > mapped_size - position){
+            throw std::runtime_error("Truncated ciphertext container");
+        }
+
+        // Metadata is made of "key=value" lines
+        std::istringstream metadata_lines(std::string(mapped_data + position, metadata_size));
+        std::string line;
+        while(std::getline(metadata_lines, line)){
+            size_t separator = line.find('=');
+            if(separator != std::string::npos){
+                metadata[line.substr(0, separator)] = line.substr(separator + 1);
+            }
+        }
+        position += metadata_size;
+
+        for(uint64_t i = 0; i < number_entries; i++){
+            uint64_t offset = read_u64(mapped_data, mapped_size, position);
+            uint64_t size = read_u64(mapped_data, mapped_size, position);
+
+            if(offset > mapped_size || size > mapped_size - offset){
+                throw std::runtime_error("Entry outside of the ciphertext container");
+            }
+
+            offsets.push_back(offset);
+            sizes.push_back(size);
+        }
+    }
+    catch(...){
+        munmap((void*)mapped_data, mapped_size);
+        throw;
+    }
+}
+
+CiphertextContainer::~CiphertextContainer(){
+    munmap((void*)mapped_data, mapped_size);
+}
+
+Ciphertext<DCRTPoly> CiphertextContainer::get(size_t index) const {
+    MemoryStreamBuffer buffer(mapped_data + offsets.at(index), sizes.at(index));
+    std::istream stream(&buffer);
+
+    Ciphertext<DCRTPoly> ciphertext;
+    Serial::Deserialize(ciphertext, stream, SerType::BINARY);
+
+    return ciphertext;
+}
+
+std::vector<Ciphertext<DCRTPoly>> CiphertextContainer::getAll() const {
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+
+    for(size_t i = 0; i < size(); i++){
+        ciphertexts.push_back(get(i));
+    }
+
+    return ciphertexts;
+}
+
+std::string CiphertextContainer::getMetadata(const std::string& key) const {
+    auto it = metadata.find(key);
+
+    return it == metadata.end() ? "" : it->second;
+}
@@ -0,0 +1,71 @@
+#ifndef CIPHERTEXT_CONTAINER_H
+#define CIPHERTEXT_CONTAINER_H
+
+#include "serialization.h"
+
+#include <fstream>
+#include <map>
+
+/*
+ * Binary container used to move ciphertexts between the encryptor, the evaluator and the decryptor.
+ *
+ * Layout (all integers are little endian, 64 bit except the version):
+ *   "HECT" | version (32 bit) | number of entries | metadata size | metadata ("key=value" lines)
+ *   | table with (offset, size) of every entry | serialized ciphertexts
+ *
+ * The writer serializes each ciphertext straight into the file. The reader maps the file into memory
+ * and deserializes each ciphertext directly from the mapped bytes, without copying them first.
+ */
+
+typedef std::map<std::string, std::string> ContainerMetadata;
+
+class ContainerWriter {
+public:
+    ContainerWriter(const std::string& path, const ContainerMetadata& metadata, uint64_t number_entries);
+
+    // Serialize the next ciphertext into the file
+    void add(ConstCiphertext<DCRTPoly> ciphertext);
+
+    // Write the table of entries and close the file. Returns the size of the file in bytes
+    uint64_t finish();
+
+private:
+    std::string path;
+    std::ofstream file;
+    uint64_t number_entries;
+    uint64_t table_position;
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> sizes;
+};
+
+class CiphertextContainer {
+public:
+    explicit CiphertextContainer(const std::string& path);
+    ~CiphertextContainer();
+
+    CiphertextContainer(const CiphertextContainer&) = delete;
+    CiphertextContainer& operator=(const CiphertextContainer&) = delete;
+
+    size_t size() const { return offsets.size(); }
+
+    // Deserialize one ciphertext from the mapped file
+    Ciphertext<DCRTPoly> get(size_t index) const;
+
+    // Deserialize all the ciphertexts
+    std::vector<Ciphertext<DCRTPoly>> getAll() const;
+
+    // Empty if the key is not in the metadata
+    std::string getMetadata(const std::string& key) const;
+
+    // Size of the whole file
+    uint64_t bytes() const { return mapped_size; }
+
+private:
+    const char* mapped_data = nullptr;
+    size_t mapped_size = 0;
+    ContainerMetadata metadata;
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> sizes;
+};
+
+#endif
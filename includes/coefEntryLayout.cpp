@@ -0,0 +1,77 @@
+#include "coefEntryLayout.h"
+
+CoefEntryLayout::CoefEntryLayout(CryptoContext<DCRTPoly> cryptoContext, int64_t number_columns, int64_t chunk_length)
+    : cryptoContext(cryptoContext){
+    for(int64_t a = 0; a < number_columns; a++){
+        entries.push_back({a, -1});
+    }
+    for(int64_t a = 0; a < number_columns; a++){
+        for(int64_t b = a; b < number_columns; b++){
+            entries.push_back({a, b});
+        }
+    }
+
+    int64_t ring_dimension = cryptoContext->GetRingDimension();
+
+    if(chunk_length > 0){
+        this->chunk_length = std::min<int64_t>(chunk_length, ring_dimension / 2);
+    }
+    else{
+        this->chunk_length = std::max<int64_t>(1, ring_dimension / (2 * pow(2, ceil(log2(numberEntries())))));
+    }
+
+    entries_per_ciphertext = ring_dimension / (2 * this->chunk_length);
+
+    for(int64_t p = 0; p < entries_per_ciphertext; p++){
+        std::vector<int64_t> monomial(2 * this->chunk_length * p + 1, 0);
+        monomial.back() = 1;
+        shiftPlaintexts.push_back(cryptoContext->MakeCoefPackedPlaintext(monomial));
+
+        std::vector<int64_t> shifted_ones(2 * this->chunk_length * p + this->chunk_length, 0);
+        std::fill(shifted_ones.begin() + 2 * this->chunk_length * p, shifted_ones.end(), 1);
+        shiftedOnesPlaintexts.push_back(cryptoContext->MakeCoefPackedPlaintext(shifted_ones));
+    }
+}
+
+std::vector<Ciphertext<DCRTPoly>> CoefEntryLayout::placeEntries(const std::vector<Ciphertext<DCRTPoly>>& entryCiphertexts) const {
+    std::vector<Ciphertext<DCRTPoly>> resultCiphertexts;
+
+    for(int64_t first = 0; first < numberEntries(); first += entries_per_ciphertext){
+        // Products are kept without relinearization until every entry of the result ciphertext is added
+        std::vector<Ciphertext<DCRTPoly>> linearCiphertexts, productCiphertexts;
+
+        for(int64_t e = first; e < std::min(first + entries_per_ciphertext, numberEntries()); e++){
+            if(entries[e].second < 0){
+                // Column sum: the shifted vector of ones adds the chunk's values on index 2Lp + L - 1
+                linearCiphertexts.push_back(cryptoContext->EvalMult(entryCiphertexts[e], shiftedOnesPlaintexts[e - first]));
+            }
+            else{
+                productCiphertexts.push_back(cryptoContext->EvalMult(entryCiphertexts[e], shiftPlaintexts[e - first]));
+            }
+        }
+
+        Ciphertext<DCRTPoly> resultCiphertext;
+
+        if(!productCiphertexts.empty()){
+            resultCiphertext = cryptoContext->Relinearize(cryptoContext->EvalAddMany(productCiphertexts));
+        }
+        if(!linearCiphertexts.empty()){
+            Ciphertext<DCRTPoly> linearCiphertext = cryptoContext->EvalAddMany(linearCiphertexts);
+            resultCiphertext = resultCiphertext ? cryptoContext->EvalAdd(resultCiphertext, linearCiphertext) : linearCiphertext;
+        }
+
+        resultCiphertexts.push_back(resultCiphertext);
+    }
+
+    return resultCiphertexts;
+}
+
+std::vector<uint32_t> CoefEntryLayout::entryIndexes() const {
+    std::vector<uint32_t> indexes;
+
+    for(int64_t p = 0; p < entries_per_ciphertext; p++){
+        indexes.push_back(2 * chunk_length * p + chunk_length - 1);
+    }
+
+    return indexes;
+}
@@ -0,0 +1,50 @@
+#ifndef COEF_ENTRY_LAYOUT_H
+#define COEF_ENTRY_LAYOUT_H
+
+#include "openfhe.h"
+
+using namespace lbcrypto;
+
+/*
+ * Coefficient packing layout of the sums of k columns, shared by the coef covariance matrix and the least squares.
+ *
+ * Entries: the sum of every column, (a, -1), followed by the cross sum sum(x_a * x_b) of every pair a <= b.
+ * Each column is split in chunks of length L, encrypted as they are and reversed. The product of a chunk by a reversed
+ * chunk has degree 2L - 2, with the sum of the products at index L - 1. Shifting entry p of a result ciphertext by the
+ * monomial X^(2Lp) moves it to index 2Lp + L - 1 without overlapping the others, so N/(2L) entries fit in each result.
+ */
+class CoefEntryLayout {
+public:
+    // chunk_length 0 picks the longest chunks that still fit every entry in one result ciphertext
+    CoefEntryLayout(CryptoContext<DCRTPoly> cryptoContext, int64_t number_columns, int64_t chunk_length);
+
+    /*
+     * Result ciphertexts with every entry moved into its place. entryCiphertexts[e] is the sum of the chunks of the column
+     * for a column sum, or the sum of the (not relinearized) products of the chunks of a by the reversed chunks of b for a
+     * cross sum. Each result ciphertext is relinearized only once, after its entries are added.
+     */
+    std::vector<Ciphertext<DCRTPoly>> placeEntries(const std::vector<Ciphertext<DCRTPoly>>& entryCiphertexts) const;
+
+    // Coefficients of a result ciphertext that hold entries, for decrypt_coefficients
+    std::vector<uint32_t> entryIndexes() const;
+
+    const std::vector<std::pair<int64_t, int64_t>>& getEntries() const { return entries; }
+
+    int64_t numberEntries() const { return entries.size(); }
+    int64_t chunkLength() const { return chunk_length; }
+    int64_t entriesPerCiphertext() const { return entries_per_ciphertext; }
+    int64_t numberResults() const { return (numberEntries() + entries_per_ciphertext - 1) / entries_per_ciphertext; }
+
+private:
+    CryptoContext<DCRTPoly> cryptoContext;
+    std::vector<std::pair<int64_t, int64_t>> entries;
+    int64_t chunk_length;
+    int64_t entries_per_ciphertext;
+
+    // Monomials X^(2Lp), and the same shift applied to the vector of ones (ones on 2Lp to 2Lp + L - 1),
+    // so a column sum is calculated and moved into place by a single multiplication
+    std::vector<Plaintext> shiftPlaintexts;
+    std::vector<Plaintext> shiftedOnesPlaintexts;
+};
+
+#endif
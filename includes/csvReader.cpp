@@ -0,0 +1,306 @@
+#include "csvReader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Columns parsed by one thread, plus the position of the first line that could not be parsed
+struct CsvBlock {
+    std::vector<std::vector<int64_t>> values;
+    const char* error_line = nullptr;
+    std::string error;
+};
+
+static const char* find_line_end(const char* position, const char* end){
+    const char* newline = (const char*)memchr(position, '\n', end - position);
+    return newline ? newline : end;
+}
+
+static const char* trim_begin(const char* begin, const char* end){
+    while(begin < end && (*begin == ' ' || *begin == '\t')){
+        begin++;
+    }
+    return begin;
+}
+
+static const char* trim_end(const char* begin, const char* end){
+    while(end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')){
+        end--;
+    }
+    return end;
+}
+
+bool parse_fixed_point(const char* begin, const char* end, int decimals, int64_t& value){
+    begin = trim_begin(begin, end);
+    end = trim_end(begin, end);
+
+    bool negative = false;
+    if(begin < end && (*begin == '-' || *begin == '+')){
+        negative = *begin == '-';
+        begin++;
+    }
+
+    // Integer part, it can be empty as in ".5"
+    uint64_t integer_part = 0;
+    const char* position = begin;
+
+    if(position < end && *position != '.'){
+        auto [next, error] = std::from_chars(position, end, integer_part);
+        if(error != std::errc()){
+            return false;
+        }
+        position = next;
+    }
+
+    bool has_digits = position > begin;
+
+    // Fractional part, padded with zeros or rounded to the number of decimals
+    uint64_t fractional_part = 0;
+    int digits = 0;
+    bool round_up = false;
+
+    if(position < end && *position == '.'){
+        const char* fraction_begin = ++position;
+
+        while(position < end && *position >= '0' && *position <= '9'){
+            if(position - fraction_begin < decimals){
+                fractional_part = fractional_part * 10 + (*position - '0');
+                digits++;
+            }
+            else if(position - fraction_begin == decimals){
+                round_up = *position >= '5';
+            }
+            position++;
+        }
+
+        has_digits = has_digits || position > fraction_begin;
+    }
+
+    if(!has_digits || position != end){
+        return false;
+    }
+
+    for(; digits < decimals; digits++){
+        fractional_part *= 10;
+    }
+
+    uint64_t scale = 1;
+    for(int i = 0; i < decimals; i++){
+        scale *= 10;
+    }
+
+    // Check the overflow before building integer_part * scale + fractional_part
+    uint64_t magnitude;
+    if(__builtin_mul_overflow(integer_part, scale, &magnitude) || __builtin_add_overflow(magnitude, fractional_part + round_up, &magnitude)
+       || magnitude > (uint64_t)INT64_MAX){
+        return false;
+    }
+
+    value = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+
+    return true;
+}
+
+// Parse every line from begin to end, each one must have number_columns fields
+static CsvBlock parse_block(const char* begin, const char* end, size_t number_columns, int decimals, char delimiter){
+    CsvBlock block;
+    block.values.resize(number_columns);
+
+    for(const char* line = begin; line < end; ){
+        const char* line_end = find_line_end(line, end);
+
+        // Empty lines are skipped
+        if(trim_end(line, line_end) > trim_begin(line, line_end)){
+            const char* field = line;
+
+            for(size_t c = 0; c < number_columns; c++){
+                const char* field_end = (const char*)memchr(field, delimiter, line_end - field);
+                bool last = c + 1 == number_columns;
+
+                if(last != (field_end == nullptr)){
+                    block.error_line = line;
+                    block.error = "expected " + std::to_string(number_columns) + " fields";
+                    return block;
+                }
+                if(last){
+                    field_end = line_end;
+                }
+
+                int64_t value;
+                if(!parse_fixed_point(field, field_end, decimals, value)){
+                    block.error_line = line;
+                    block.error = "invalid number '" + std::string(field, field_end) + "'";
+                    return block;
+                }
+
+                block.values[c].push_back(value);
+                field = field_end + 1;
+            }
+        }
+
+        line = line_end + 1;
+    }
+
+    return block;
+}
+
+CsvColumns read_csv_columns(const std::string& path, int decimals, unsigned int number_threads, char delimiter, bool has_header){
+    if(decimals < 0 || decimals > 18){
+        throw std::invalid_argument("read_csv_columns: decimals must be between 0 and 18");
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("Could not open the file '" + path + "'");
+    }
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) < 0 || file_stat.st_size == 0){
+        close(fd);
+        throw std::runtime_error("Could not read the file '" + path + "'");
+    }
+
+    size_t mapped_size = file_stat.st_size;
+    void* data = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED){
+        throw std::runtime_error("Could not map the file '" + path + "'");
+    }
+
+    // The lines are read from start to end by each thread
+    madvise(data, mapped_size, MADV_SEQUENTIAL);
+
+    const char* file_begin = (const char*)data;
+    const char* file_end = file_begin + mapped_size;
+
+    CsvColumns csv;
+    csv.scale = 1;
+    for(int i = 0; i < decimals; i++){
+        csv.scale *= 10;
+    }
+
+    std::vector<CsvBlock> blocks;
+
+    try{
+        // The first line gives the number of columns
+        const char* first_line_end = find_line_end(file_begin, file_end);
+        const char* body = file_begin;
+
+        for(const char* field = file_begin; ; ){
+            const char* field_end = (const char*)memchr(field, delimiter, first_line_end - field);
+            const char* name_end = field_end ? field_end : first_line_end;
+
+            csv.names.push_back(std::string(trim_begin(field, name_end), trim_end(trim_begin(field, name_end), name_end)));
+
+            if(!field_end){
+                break;
+            }
+            field = field_end + 1;
+        }
+
+        if(has_header){
+            body = first_line_end + (first_line_end < file_end);
+        }
+        else{
+            for(size_t c = 0; c < csv.names.size(); c++){
+                csv.names[c] = "column " + std::to_string(c);
+            }
+        }
+
+        // Split the body in blocks of about the same size, each one ending at the end of a line
+        std::vector<std::pair<const char*, const char*>> ranges;
+        size_t block_size = (file_end - body) / std::max(1u, number_threads) + 1;
+
+        for(const char* position = body; position < file_end; ){
+            const char* boundary = position + std::min<size_t>(block_size, file_end - position);
+
+            if(boundary < file_end){
+                boundary = std::min(find_line_end(boundary, file_end) + 1, file_end);
+            }
+
+            ranges.push_back({position, boundary});
+            position = boundary;
+        }
+
+        ThreadPool pool(number_threads);
+        std::vector<std::future<CsvBlock>> parsed;
+        size_t number_columns = csv.names.size();
+
+        for(size_t b = 0; b < ranges.size(); b++){
+            const char* block_begin = ranges[b].first;
+            const char* block_end = ranges[b].second;
+
+            parsed.push_back(pool.submit([block_begin, block_end, number_columns, decimals, delimiter]() {
+                return parse_block(block_begin, block_end, number_columns, decimals, delimiter);
+            }));
+        }
+
+        for(size_t b = 0; b < parsed.size(); b++){
+            blocks.push_back(parsed[b].get());
+        }
+
+        for(size_t b = 0; b < blocks.size(); b++){
+            if(blocks[b].error_line){
+                // Line numbers are only counted when something goes wrong
+                int64_t line_number = 1 + std::count(file_begin, blocks[b].error_line, '\n');
+
+                throw std::runtime_error("Line " + std::to_string(line_number) + " of '" + path + "': " + blocks[b].error);
+            }
+        }
+    }
+    catch(...){
+        munmap(data, mapped_size);
+        throw;
+    }
+
+    munmap(data, mapped_size);
+
+    // Concatenate the blocks in the file order
+    csv.values.resize(csv.names.size());
+
+    for(size_t c = 0; c < csv.values.size(); c++){
+        size_t number_rows = 0;
+        for(size_t b = 0; b < blocks.size(); b++){
+            number_rows += blocks[b].values[c].size();
+        }
+
+        csv.values[c].reserve(number_rows);
+        for(size_t b = 0; b < blocks.size(); b++){
+            csv.values[c].insert(csv.values[c].end(), blocks[b].values[c].begin(), blocks[b].values[c].end());
+        }
+    }
+
+    return csv;
+}
+
+std::vector<std::vector<int64_t>> pack_interleaved_columns(const std::vector<std::vector<int64_t>>& columns, int64_t segment_width, int64_t row_size){
+    if((int64_t)columns.size() * segment_width > row_size){
+        throw std::invalid_argument("pack_interleaved_columns: more columns than segments");
+    }
+
+    std::vector<std::vector<int64_t>> packed_values;
+    size_t number_rows = columns.empty() ? 0 : columns[0].size();
+
+    // Each slot vector holds 2 * segment_width rows of every column, the same split between both rows as pack_first_segment
+    for(size_t begin = 0; begin < number_rows; begin += 2 * segment_width){
+        std::vector<int64_t> slots(2 * row_size, 0);
+
+        for(size_t c = 0; c < columns.size(); c++){
+            for(int64_t i = 0; i < 2 * segment_width && begin + i < number_rows; i++){
+                int64_t slot = c * segment_width + (i < segment_width ? i : row_size + i - segment_width);
+
+                slots[slot] = columns[c][begin + i];
+            }
+        }
+
+        packed_values.push_back(slots);
+    }
+
+    return packed_values;
+}
@@ -0,0 +1,47 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include "threadPool.h"
+
+#include <string>
+
+/*
+ * Reader for wide CSV files with one column per variable, e.g.
+ *   age,height,weight
+ *   31,1.82,80.5
+ *
+ * BFV only encrypts integers, so every value is read as a fixed point number with the given number of decimals:
+ * with 2 decimals "1.82" is 182 and "80.5" is 8050. Extra decimals are rounded (half away from zero).
+ *
+ * The file is mapped into memory and split into one block of lines per thread. Each thread parses its block
+ * with std::from_chars into its own columns, and the blocks are then concatenated in the file order.
+ */
+
+struct CsvColumns {
+    // Names from the header line, or "column i" when the file has no header
+    std::vector<std::string> names;
+
+    // values[c][r] is the value of column c in row r, multiplied by scale
+    std::vector<std::vector<int64_t>> values;
+
+    // 10^decimals, divide the results by it (by scale^2 for squares and products)
+    int64_t scale;
+};
+
+CsvColumns read_csv_columns(const std::string& path, int decimals, unsigned int number_threads, char delimiter = ',', bool has_header = true);
+
+// Parse a single field as a fixed point number. Returns false if the field is not a number or does not fit in 64 bits
+bool parse_fixed_point(const char* begin, const char* end, int decimals, int64_t& value);
+
+/*
+ * Layouts of the columns in the slots, both based on the segments of "includes/auxiliaryFunctions.h".
+ *
+ * Column per ciphertext: each column is packed on its own with pack_first_segment, so each column has its own ciphertexts.
+ *
+ * Interleaved: every slot vector holds the same rows of all the columns, column c in segment c of both rows.
+ * The chunks of all the columns are added (and squared) together and a single rotate_and_sum of log2(segment_width)
+ * rotations reduces every column at the same time. Needs at least as many segments as columns.
+ */
+std::vector<std::vector<int64_t>> pack_interleaved_columns(const std::vector<std::vector<int64_t>>& columns, int64_t segment_width, int64_t row_size);
+
+#endif
@@ -0,0 +1,103 @@
+#include "encryptedAggregate.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+EncryptedAggregate::EncryptedAggregate(const std::string& path){
+    CiphertextContainer container(path);
+
+    if(container.getMetadata("type") != "aggregate"){
+        throw std::runtime_error("'" + path + "' is not an encrypted aggregate");
+    }
+
+    number_elements = std::stoll(container.getMetadata("count"));
+    fingerprint = container.getMetadata("fingerprint");
+
+    if(number_elements > 0){
+        if(container.size() != 2){
+            throw std::runtime_error("Encrypted aggregate '" + path + "' is missing its sums");
+        }
+
+        sumCiphertext = container.get(0);
+        squareSumCiphertext = container.get(1);
+    }
+}
+
+uint64_t EncryptedAggregate::save(const std::string& path) const {
+    ContainerMetadata metadata;
+    metadata["type"] = "aggregate";
+    metadata["count"] = std::to_string(number_elements);
+    metadata["fingerprint"] = fingerprint;
+
+    // Write next to the old file and rename it, so a failed save never leaves a broken aggregate behind
+    std::string temporary_path = path + ".tmp";
+
+    ContainerWriter writer(temporary_path, metadata, empty() ? 0 : 2);
+    if(!empty()){
+        writer.add(sumCiphertext);
+        writer.add(squareSumCiphertext);
+    }
+    uint64_t bytes = writer.finish();
+
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+        throw std::runtime_error("Could not replace '" + path + "'");
+    }
+
+    return bytes;
+}
+
+void EncryptedAggregate::checkKeys(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey) const {
+    if(!fingerprint.empty() && context_fingerprint(cryptoContext, publicKey) != fingerprint){
+        throw std::runtime_error("The aggregate was encrypted with other keys");
+    }
+}
+
+void EncryptedAggregate::append(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey, const std::vector<int64_t>& values, const SegmentLayout& layout){
+    checkKeys(cryptoContext, publicKey);
+
+    if(values.empty()){
+        return;
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> ciphertexts;
+    std::vector<Ciphertext<DCRTPoly>> squareCiphertexts;
+    std::vector<std::vector<int64_t>> packed_numbers = pack_first_segment(values, layout.segment_width, layout.row_size);
+
+    for(size_t i = 0; i < packed_numbers.size(); i++){
+        Plaintext plaintext = cryptoContext->MakePackedPlaintext(packed_numbers[i]);
+        ciphertexts.push_back(cryptoContext->Encrypt(publicKey, plaintext));
+
+        // The squares are only relinearized once, after being added together
+        squareCiphertexts.push_back(cryptoContext->EvalMultNoRelin(ciphertexts[i], ciphertexts[i]));
+    }
+
+    auto batchSum = cryptoContext->EvalAddMany(ciphertexts);
+    auto batchSquareSum = cryptoContext->Relinearize(cryptoContext->EvalAddMany(squareCiphertexts));
+
+    if(empty()){
+        sumCiphertext = batchSum;
+        squareSumCiphertext = batchSquareSum;
+    }
+    else{
+        sumCiphertext = cryptoContext->EvalAdd(sumCiphertext, batchSum);
+        squareSumCiphertext = cryptoContext->EvalAdd(squareSumCiphertext, batchSquareSum);
+    }
+
+    number_elements += values.size();
+    fingerprint = context_fingerprint(cryptoContext, publicKey);
+}
+
+Ciphertext<DCRTPoly> EncryptedAggregate::evaluate(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const SegmentLayout& layout) const {
+    if(empty()){
+        throw std::runtime_error("The aggregate is empty");
+    }
+
+    if(statistic == "mean"){
+        return rotate_and_sum(cryptoContext, sumCiphertext, layout.number_rotations);
+    }
+    if(statistic == "variance"){
+        return reduce_sum_and_square_sum(cryptoContext, sumCiphertext, squareSumCiphertext, layout);
+    }
+
+    throw std::invalid_argument("The aggregate only holds the mean and the variance, not '" + statistic + "'");
+}
@@ -0,0 +1,49 @@
+#ifndef ENCRYPTED_AGGREGATE_H
+#define ENCRYPTED_AGGREGATE_H
+
+#include "ciphertextContainer.h"
+#include "homomorphicStatistics.h"
+
+/*
+ * Running encrypted sums of append-only data: the slot-wise sum of x, the slot-wise sum of x^2 and the number of values.
+ * Appending a batch only encrypts that batch and adds it into the sums, and the mean or the variance of everything
+ * appended so far can be evaluated at any time, with a single rotate and sum.
+ *
+ * The aggregate is saved as a ciphertext container with the count and the fingerprint of the context and public key
+ * in the metadata and the two sums as entries (no entries while nothing has been appended). The first append
+ * records the fingerprint, and later appends and queries must use the same keys.
+ */
+class EncryptedAggregate {
+public:
+    // Empty aggregate, nothing appended yet
+    EncryptedAggregate() = default;
+
+    // Load an aggregate written by save
+    explicit EncryptedAggregate(const std::string& path);
+
+    // Write the aggregate into a new file that then replaces the old one. Returns the size of the file in bytes
+    uint64_t save(const std::string& path) const;
+
+    // Throws std::runtime_error if the context and public key are not the ones the sums were encrypted with
+    void checkKeys(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey) const;
+
+    // Encrypt the new values, packed in the first segment, and add them and their squares into the running sums
+    void append(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey, const std::vector<int64_t>& values, const SegmentLayout& layout);
+
+    // Result ciphertext of the "mean" or the "variance", finished with finish_statistic and count()
+    Ciphertext<DCRTPoly> evaluate(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const SegmentLayout& layout) const;
+
+    int64_t count() const { return number_elements; }
+
+    bool empty() const { return number_elements == 0; }
+
+private:
+    Ciphertext<DCRTPoly> sumCiphertext;
+    Ciphertext<DCRTPoly> squareSumCiphertext;
+    int64_t number_elements = 0;
+
+    // context_fingerprint of the keys of the sums, empty while nothing has been appended
+    std::string fingerprint;
+};
+
+#endif
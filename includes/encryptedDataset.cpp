@@ -0,0 +1,314 @@
+#include "encryptedDataset.h"
+#include "partialDecryption.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+int64_t DatasetManifest::count() const {
+    int64_t total = 0;
+    for(size_t i = 0; i < part_counts.size(); i++){
+        total += part_counts[i];
+    }
+    return total;
+}
+
+static std::string manifest_path(const std::string& directory){
+    return directory + "/manifest.txt";
+}
+
+EncryptedDataset::EncryptedDataset(const std::string& directory, const DatasetManifest& manifest)
+    : directory(directory), manifest(manifest) {}
+
+EncryptedDataset::EncryptedDataset(const std::string& directory) : directory(directory) {
+    std::ifstream file(manifest_path(directory));
+    if(!file.is_open()){
+        throw std::runtime_error("'" + directory + "' is not an encrypted dataset");
+    }
+
+    std::map<std::string, std::string> values;
+    std::string line;
+
+    while(std::getline(file, line)){
+        size_t separator = line.find('=');
+        if(separator != std::string::npos){
+            values[line.substr(0, separator)] = line.substr(separator + 1);
+        }
+    }
+
+    if(values["type"] != "dataset" || (values["packing"] != "slot" && values["packing"] != "coef")){
+        throw std::runtime_error("Invalid manifest in '" + directory + "'");
+    }
+
+    manifest.id = values["id"];
+    manifest.packing = values["packing"];
+    manifest.chunk_length = std::stoll(values["chunk_length"]);
+    manifest.ring_dimension = std::stoul(values["ring_dimension"]);
+    manifest.plaintext_modulus = std::stoll(values["plaintext_modulus"]);
+    manifest.fingerprint = values["fingerprint"];
+    manifest.generation = std::stoll(values["generation"]);
+
+    std::istringstream counts(values["part_counts"]);
+    std::string count;
+    while(std::getline(counts, count, ',')){
+        manifest.part_counts.push_back(std::stoll(count));
+    }
+}
+
+EncryptedDataset EncryptedDataset::create(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                                          const std::string& packing, int64_t chunk_length){
+    uint32_t ring_dimension = cryptoContext->GetRingDimension();
+
+    DatasetManifest manifest;
+    manifest.id = hash_bytes(directory + ":" + std::to_string(std::random_device()()) + ":" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()));
+    manifest.packing = packing;
+    manifest.ring_dimension = ring_dimension;
+    manifest.plaintext_modulus = cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+    manifest.fingerprint = context_fingerprint(cryptoContext, publicKey);
+
+    if(packing == "slot"){
+        // Both first segments of the layout of the statistics
+        manifest.chunk_length = 2 * make_segment_layout(cryptoContext).segment_width;
+    }
+    else if(packing == "coef"){
+        chunk_length = chunk_length == 0 ? ring_dimension / 4 : chunk_length;
+
+        if(chunk_length <= 0 || chunk_length > ring_dimension / 4){
+            throw std::invalid_argument("The chunk length of the coef packing must be between 1 and " + std::to_string(ring_dimension / 4));
+        }
+        manifest.chunk_length = chunk_length;
+    }
+    else{
+        throw std::invalid_argument("Unknown packing '" + packing + "'");
+    }
+
+    if(mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST){
+        throw std::runtime_error("Could not create the dataset directory '" + directory + "'");
+    }
+
+    EncryptedDataset dataset(directory, manifest);
+    dataset.saveManifest();
+
+    return dataset;
+}
+
+void EncryptedDataset::saveManifest() const {
+    std::string path = manifest_path(directory);
+    std::string temporary_path = path + ".tmp";
+
+    std::ofstream file(temporary_path);
+    if(!file.is_open()){
+        throw std::runtime_error("Could not write '" + temporary_path + "'");
+    }
+
+    file << "type=dataset\n";
+    file << "id=" << manifest.id << "\n";
+    file << "packing=" << manifest.packing << "\n";
+    file << "chunk_length=" << manifest.chunk_length << "\n";
+    file << "ring_dimension=" << manifest.ring_dimension << "\n";
+    file << "plaintext_modulus=" << manifest.plaintext_modulus << "\n";
+    file << "fingerprint=" << manifest.fingerprint << "\n";
+    file << "generation=" << manifest.generation << "\n";
+    file << "part_counts=";
+    for(size_t i = 0; i < manifest.part_counts.size(); i++){
+        file << (i > 0 ? "," : "") << manifest.part_counts[i];
+    }
+    file << "\n";
+
+    file.close();
+    if(file.fail()){
+        throw std::runtime_error("Could not write '" + temporary_path + "'");
+    }
+
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+        throw std::runtime_error("Could not replace '" + path + "'");
+    }
+}
+
+std::string EncryptedDataset::partPath(size_t part) const {
+    return directory + "/part-" + std::to_string(part) + ".bin";
+}
+
+void EncryptedDataset::checkKeys(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey) const {
+    if(context_fingerprint(cryptoContext, publicKey) != manifest.fingerprint){
+        throw std::runtime_error("The dataset '" + directory + "' was encrypted with other keys");
+    }
+}
+
+uint64_t EncryptedDataset::append(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey, const std::vector<int64_t>& values){
+    checkKeys(cryptoContext, publicKey);
+
+    if(values.empty()){
+        return 0;
+    }
+
+    std::vector<std::vector<int64_t>> chunks;
+    std::vector<Plaintext> plaintexts;
+
+    if(manifest.packing == "slot"){
+        SegmentLayout layout = make_segment_layout(cryptoContext);
+        chunks = pack_first_segment(values, layout.segment_width, layout.row_size);
+
+        for(size_t i = 0; i < chunks.size(); i++){
+            plaintexts.push_back(cryptoContext->MakePackedPlaintext(chunks[i]));
+        }
+    }
+    else{
+        for(size_t begin = 0; begin < values.size(); begin += manifest.chunk_length){
+            // The last chunk is padded with zeros before being reversed, so its products still end at chunk_length - 1
+            std::vector<int64_t> numbers(manifest.chunk_length, 0);
+            std::copy(values.begin() + begin, values.begin() + std::min(values.size(), begin + manifest.chunk_length), numbers.begin());
+
+            std::vector<int64_t> reversed_numbers(numbers.rbegin(), numbers.rend());
+
+            plaintexts.push_back(cryptoContext->MakeCoefPackedPlaintext(numbers));
+            plaintexts.push_back(cryptoContext->MakeCoefPackedPlaintext(reversed_numbers));
+        }
+    }
+
+    ContainerMetadata metadata;
+    metadata["type"] = "dataset-part";
+    metadata["packing"] = manifest.packing;
+    metadata["count"] = std::to_string(values.size());
+    metadata["copies"] = manifest.packing == "slot" ? "1" : "2";
+
+    // The part is written before the manifest, so a part left by a failed append is never read and is overwritten by the next one
+    size_t part = manifest.part_counts.size();
+
+    ContainerWriter writer(partPath(part), metadata, plaintexts.size());
+    for(size_t i = 0; i < plaintexts.size(); i++){
+        writer.add(cryptoContext->Encrypt(publicKey, plaintexts[i]));
+    }
+    uint64_t bytes = writer.finish();
+
+    manifest.part_counts.push_back(values.size());
+    manifest.generation++;
+    saveManifest();
+
+    return bytes;
+}
+
+std::vector<Ciphertext<DCRTPoly>> EncryptedDataset::loadChunks(int copy) const {
+    int copies = manifest.packing == "slot" ? 1 : 2;
+    if(copy < 0 || copy >= copies){
+        throw std::invalid_argument("The " + manifest.packing + " packing has no copy " + std::to_string(copy));
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> chunks;
+
+    for(size_t part = 0; part < manifest.part_counts.size(); part++){
+        CiphertextContainer container(partPath(part));
+
+        if(container.getMetadata("type") != "dataset-part" || std::stoll(container.getMetadata("count")) != manifest.part_counts[part]){
+            throw std::runtime_error("'" + partPath(part) + "' does not match the manifest of the dataset");
+        }
+
+        // Copies are stored one after the other for each chunk
+        for(size_t i = copy; i < container.size(); i += copies){
+            chunks.push_back(container.get(i));
+        }
+    }
+
+    return chunks;
+}
+
+// Coefficient vector with a single 1 at the given index
+static Plaintext make_monomial(CryptoContext<DCRTPoly> cryptoContext, int64_t index){
+    std::vector<int64_t> coefficients(index + 1, 0);
+    coefficients[index] = 1;
+
+    return cryptoContext->MakeCoefPackedPlaintext(coefficients);
+}
+
+Ciphertext<DCRTPoly> EncryptedDataset::evaluate(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const EncryptedDataset* other) const {
+    if(manifest.part_counts.empty()){
+        throw std::runtime_error("The dataset '" + directory + "' is empty");
+    }
+
+    if(statistic == "inner-product"){
+        if(!other || other->manifest.packing != manifest.packing || other->manifest.chunk_length != manifest.chunk_length
+           || other->manifest.part_counts != manifest.part_counts){
+            throw std::invalid_argument("The inner product needs a second dataset with the same packing, appended in batches of the same size");
+        }
+    }
+    else if(statistic != "mean" && statistic != "variance"){
+        throw std::invalid_argument("Unknown statistic '" + statistic + "'");
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> chunks = loadChunks(0);
+
+    if(manifest.packing == "slot"){
+        SegmentLayout layout = make_segment_layout(cryptoContext);
+
+        if(statistic == "inner-product"){
+            // evaluate_statistic multiplies the first half of the ciphertexts by the second half
+            std::vector<Ciphertext<DCRTPoly>> otherChunks = other->loadChunks(0);
+            chunks.insert(chunks.end(), otherChunks.begin(), otherChunks.end());
+        }
+
+        return evaluate_statistic(cryptoContext, statistic, chunks, layout);
+    }
+
+    // Coefficient packing: chunk times reversed chunk, relinearized once after adding them together
+    if(statistic == "inner-product"){
+        std::vector<Ciphertext<DCRTPoly>> reversedChunks = other->loadChunks(1);
+        std::vector<Ciphertext<DCRTPoly>> multCiphertexts;
+
+        for(size_t i = 0; i < chunks.size(); i++){
+            multCiphertexts.push_back(cryptoContext->EvalMultNoRelin(chunks[i], reversedChunks[i]));
+        }
+
+        return cryptoContext->Relinearize(cryptoContext->EvalAddMany(multCiphertexts));
+    }
+
+    // The sum of a chunk is its product with chunk_length ones, also at index chunk_length - 1
+    Plaintext onesPlaintext = cryptoContext->MakeCoefPackedPlaintext(std::vector<int64_t>(manifest.chunk_length, 1));
+    auto sumCiphertext = cryptoContext->EvalMult(cryptoContext->EvalAddMany(chunks), onesPlaintext);
+
+    if(statistic == "mean"){
+        return sumCiphertext;
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> reversedChunks = loadChunks(1);
+    std::vector<Ciphertext<DCRTPoly>> squareCiphertexts;
+
+    for(size_t i = 0; i < chunks.size(); i++){
+        squareCiphertexts.push_back(cryptoContext->EvalMultNoRelin(chunks[i], reversedChunks[i]));
+    }
+
+    auto squareSumCiphertext = cryptoContext->Relinearize(cryptoContext->EvalAddMany(squareCiphertexts));
+
+    // Move sum(x^2) to index 3 * chunk_length - 1, next to sum(x), so both come out of one ciphertext
+    squareSumCiphertext = cryptoContext->EvalMult(squareSumCiphertext, make_monomial(cryptoContext, 2 * manifest.chunk_length));
+
+    return cryptoContext->EvalAdd(sumCiphertext, squareSumCiphertext);
+}
+
+double EncryptedDataset::decryptResult(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey, const std::string& statistic, Ciphertext<DCRTPoly> result) const {
+    int64_t total_elements = count();
+
+    if(manifest.packing == "slot"){
+        Plaintext plaintextResult;
+        cryptoContext->Decrypt(secretKey, result, &plaintextResult);
+
+        return finish_statistic(statistic, plaintextResult->GetPackedValue(), make_segment_layout(cryptoContext), total_elements);
+    }
+
+    uint32_t sum_index = manifest.chunk_length - 1;
+    std::vector<int64_t> values = decrypt_coefficients(cryptoContext, secretKey, result, {sum_index, sum_index + 2 * (uint32_t)manifest.chunk_length});
+
+    if(statistic == "mean"){
+        return (double)values[0] / total_elements;
+    }
+    if(statistic == "inner-product"){
+        return values[0];
+    }
+
+    // Second approach formula: (n*sum(x^2) - sum(x)^2)/n^2
+    return ((long double)total_elements * values[1] - (long double)values[0] * values[0]) / pow(total_elements, 2);
+}
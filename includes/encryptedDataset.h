@@ -0,0 +1,88 @@
+#ifndef ENCRYPTED_DATASET_H
+#define ENCRYPTED_DATASET_H
+
+#include "ciphertextContainer.h"
+#include "homomorphicStatistics.h"
+
+/*
+ * Dataset encrypted once and queried many times: the chunk ciphertexts are kept on disk, so a query only
+ * deserializes them instead of reading the plaintext numbers and encrypting them again.
+ *
+ * Dataset directory:
+ *   - manifest.txt, "key=value" lines: a random id, the packing, the chunk length, the ring dimension and plaintext modulus,
+ *     the fingerprint of the context and public key, the generation (number of appends) and the number of values of each part.
+ *   - part-<i>.bin, one ciphertext container per append with the chunks of that append. Each container maps
+ *     its file and reads the table of entries from it, so a chunk is deserialized straight from the mapped bytes.
+ *
+ * Packings:
+ *   "slot" --> the values of each chunk in the first segment of both rows (pack_first_segment), one ciphertext per chunk.
+ *              The statistics are the ones of "includes/homomorphicStatistics.h".
+ *   "coef" --> chunks of chunk_length coefficients, each one encrypted as it is and reversed (two ciphertexts per chunk).
+ *              A chunk times the reversed chunk leaves the sum of the products at index chunk_length - 1,
+ *              so no rotation is needed. chunk_length can be at most ring dimension / 4, the variance moves sum(x^2)
+ *              to index 3 * chunk_length - 1 with the monomial X^(2 * chunk_length).
+ *
+ * Appending writes a new part and then the manifest (into a new file that replaces the old one), so a crash
+ * while appending leaves the dataset as it was before.
+ */
+
+struct DatasetManifest {
+    // Chosen when the dataset is created, datasets encrypted under the same keys share the fingerprint but not the id
+    std::string id;
+    std::string packing;
+    int64_t chunk_length = 0;
+    uint32_t ring_dimension = 0;
+    int64_t plaintext_modulus = 0;
+    std::string fingerprint;
+
+    // Incremented by every append, anything computed from the dataset is outdated once it changes
+    int64_t generation = 0;
+
+    // Number of values of each part
+    std::vector<int64_t> part_counts;
+
+    int64_t count() const;
+};
+
+class EncryptedDataset {
+public:
+    // Load the manifest of a dataset written by create
+    explicit EncryptedDataset(const std::string& directory);
+
+    // Create an empty dataset encrypted under the given context and public key. chunk_length is only used by the "coef" packing,
+    // 0 gives the longest chunks (ring dimension / 4)
+    static EncryptedDataset create(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey,
+                                   const std::string& packing, int64_t chunk_length);
+
+    // Throws std::runtime_error if the context and public key are not the ones the dataset was encrypted with
+    void checkKeys(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey) const;
+
+    // Encrypt the values into a new part. Returns the size of the part in bytes
+    uint64_t append(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey, const std::vector<int64_t>& values);
+
+    // Deserialize the chunks of every part. copy 0 is the chunks as they are, copy 1 the reversed ones ("coef" packing only)
+    std::vector<Ciphertext<DCRTPoly>> loadChunks(int copy) const;
+
+    // Result ciphertext of "mean", "variance" or "inner-product". The inner product needs another dataset with the
+    // same packing and the same number of values in each part, so the chunks of both line up
+    Ciphertext<DCRTPoly> evaluate(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const EncryptedDataset* other = nullptr) const;
+
+    // Decrypt a result of evaluate (only the coefficients that hold values for the "coef" packing) and finish the statistic
+    double decryptResult(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey, const std::string& statistic, Ciphertext<DCRTPoly> result) const;
+
+    const DatasetManifest& getManifest() const { return manifest; }
+
+    int64_t count() const { return manifest.count(); }
+
+private:
+    EncryptedDataset(const std::string& directory, const DatasetManifest& manifest);
+
+    void saveManifest() const;
+
+    std::string partPath(size_t part) const;
+
+    std::string directory;
+    DatasetManifest manifest;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "encryptedSegmentTree.h"
+
+#include <stdexcept>
+
+EncryptedSegmentTree::EncryptedSegmentTree(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& chunks)
+    : cryptoContext(cryptoContext), number_chunks(chunks.size()) {
+    if(chunks.empty()){
+        throw std::invalid_argument("The segment tree needs at least one chunk");
+    }
+
+    chunk_size = cryptoContext->GetRingDimension();
+    row_size = chunk_size / 2;
+    number_rotations = log2(row_size);
+
+    // Leaves go after the internal nodes, each internal node adds its two children
+    nodes.resize(2 * number_chunks);
+
+    for(size_t c = 0; c < number_chunks; c++){
+        nodes[number_chunks + c] = chunks[c];
+    }
+
+    for(size_t i = number_chunks - 1; i > 0; i--){
+        nodes[i] = cryptoContext->EvalAdd(nodes[2 * i], nodes[2 * i + 1]);
+    }
+}
+
+Ciphertext<DCRTPoly> EncryptedSegmentTree::maskedChunk(int64_t chunk, int64_t first_slot, int64_t last_slot) const {
+    std::vector<int64_t> mask(chunk_size, 0);
+
+    for(int64_t slot = first_slot; slot <= last_slot; slot++){
+        mask[slot] = 1;
+    }
+
+    // Multiplying by a plaintext does not need relinearization
+    return cryptoContext->EvalMult(nodes[number_chunks + chunk], cryptoContext->MakePackedPlaintext(mask));
+}
+
+Ciphertext<DCRTPoly> EncryptedSegmentTree::rangeSum(int64_t first, int64_t last) const {
+    if(first < 0 || last < first || last >= (int64_t)number_chunks * chunk_size){
+        throw std::out_of_range("Range " + std::to_string(first) + " to " + std::to_string(last) + " is outside of the data");
+    }
+
+    int64_t first_chunk = first / chunk_size;
+    int64_t last_chunk = last / chunk_size;
+
+    std::vector<Ciphertext<DCRTPoly>> parts;
+
+    if(first_chunk == last_chunk){
+        parts.push_back(maskedChunk(first_chunk, first % chunk_size, last % chunk_size));
+    }
+    else{
+        // Partial chunks at both ends
+        parts.push_back(maskedChunk(first_chunk, first % chunk_size, chunk_size - 1));
+        parts.push_back(maskedChunk(last_chunk, 0, last % chunk_size));
+
+        // Whole chunks in between, taking the highest nodes that fit inside the range
+        size_t left = number_chunks + first_chunk + 1;
+        size_t right = number_chunks + last_chunk;
+
+        while(left < right){
+            if(left & 1){
+                parts.push_back(nodes[left++]);
+            }
+            if(right & 1){
+                parts.push_back(nodes[--right]);
+            }
+
+            left /= 2;
+            right /= 2;
+        }
+    }
+
+    // One reduction for the whole range
+    return rotate_and_sum(cryptoContext, cryptoContext->EvalAddMany(parts), number_rotations);
+}
+
+uint64_t EncryptedSegmentTree::memoryBytes() const {
+    uint64_t bytes = 0;
+
+    // Each polynomial of a ciphertext has one 64 bit word per coefficient in every RNS tower
+    for(size_t i = 1; i < nodes.size(); i++){
+        const std::vector<DCRTPoly>& elements = nodes[i]->GetElements();
+
+        for(size_t e = 0; e < elements.size(); e++){
+            bytes += elements[e].GetNumOfElements() * elements[e].GetRingDimension() * sizeof(uint64_t);
+        }
+    }
+
+    return bytes;
+}
@@ -0,0 +1,48 @@
+#ifndef ENCRYPTED_SEGMENT_TREE_H
+#define ENCRYPTED_SEGMENT_TREE_H
+
+#include "auxiliaryFunctions.h"
+
+/*
+ * Segment tree over slot packed chunk ciphertexts, for many range sums over the same encrypted data.
+ * Chunk c holds the elements c * chunk_size to (c + 1) * chunk_size - 1, element i of the chunk in slot i,
+ * with chunk_size the ring dimension.
+ *
+ * Each node stores the slot-wise sum of the chunks below it (nodes[number_chunks + c] is chunk c), so a range of whole
+ * chunks is covered by O(log n) nodes. The partial chunks at both ends of the range are masked with a plaintext and
+ * added to those nodes, and a single rotate and sum reduces everything.
+ */
+class EncryptedSegmentTree {
+public:
+    // Needs the rotation keys of generate_rotation_indexes(log2(ring dimension / 2))
+    EncryptedSegmentTree(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& chunks);
+
+    // Encrypted sum of the elements first to last (both included), read with read_segment_sum(slots, 0, row_size, row_size)
+    Ciphertext<DCRTPoly> rangeSum(int64_t first, int64_t last) const;
+
+    // Chunk ciphertext with every slot outside first_slot to last_slot set to zero
+    Ciphertext<DCRTPoly> maskedChunk(int64_t chunk, int64_t first_slot, int64_t last_slot) const;
+
+    size_t numberChunks() const { return number_chunks; }
+
+    size_t numberNodes() const { return nodes.size() - 1; }
+
+    int64_t chunkSize() const { return chunk_size; }
+
+    int64_t rowSize() const { return row_size; }
+
+    // Memory taken by the ciphertexts of the tree, leaves included
+    uint64_t memoryBytes() const;
+
+private:
+    CryptoContext<DCRTPoly> cryptoContext;
+    int64_t chunk_size;
+    int64_t row_size;
+    int64_t number_rotations;
+    size_t number_chunks;
+
+    // nodes[0] is not used, nodes[i] is the sum of nodes[2i] and nodes[2i + 1]
+    std::vector<Ciphertext<DCRTPoly>> nodes;
+};
+
+#endif
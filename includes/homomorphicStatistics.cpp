@@ -0,0 +1,137 @@
+#include "homomorphicStatistics.h"
+
+#include <stdexcept>
+
+CryptoContext<DCRTPoly> make_statistics_context(){
+    // Set CryptoContext
+    CCParams<CryptoContextBFVRNS> parameters;
+    parameters.SetPlaintextModulus(7000000462849);
+    parameters.SetMultiplicativeDepth(2);
+
+    CryptoContext<DCRTPoly> cryptoContext = GenCryptoContext(parameters);
+    // Enable features that you wish to use
+    cryptoContext->Enable(PKE);
+    cryptoContext->Enable(KEYSWITCH);
+    cryptoContext->Enable(LEVELEDSHE);
+    cryptoContext->Enable(ADVANCEDSHE);
+
+    return cryptoContext;
+}
+
+KeyPair<DCRTPoly> generate_statistics_keys(CryptoContext<DCRTPoly> cryptoContext){
+    // Generate a public/private key pair
+    KeyPair<DCRTPoly> keyPair = cryptoContext->KeyGen();
+
+    // Generate the relinearization key
+    cryptoContext->EvalMultKeyGen(keyPair.secretKey);
+
+    // Generate the rotation evaluation keys used by every statistic
+    SegmentLayout layout = make_segment_layout(cryptoContext);
+    cryptoContext->EvalRotateKeyGen(keyPair.secretKey, statistics_rotation_indexes(layout));
+
+    return keyPair;
+}
+
+SegmentLayout make_segment_layout(CryptoContext<DCRTPoly> cryptoContext){
+    SegmentLayout layout;
+
+    layout.row_size = cryptoContext->GetRingDimension() / 2;
+    layout.segment_width = layout.row_size / 2;
+    layout.number_rotations = log2(layout.segment_width);
+
+    return layout;
+}
+
+std::vector<int32_t> statistics_rotation_indexes(const SegmentLayout& layout){
+    std::vector<int32_t> rotation_indexes = generate_rotation_indexes(layout.number_rotations);
+    rotation_indexes.push_back(segment_rotation_index(1, layout.segment_width, layout.row_size));
+
+    return rotation_indexes;
+}
+
+bool is_valid_statistic(const std::string& statistic){
+    return statistic == "mean" || statistic == "inner-product" || statistic == "variance";
+}
+
+static Ciphertext<DCRTPoly> evaluate_sum(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout){
+    auto ciphertextAdd = cryptoContext->EvalAddMany(ciphertexts);
+
+    return rotate_and_sum(cryptoContext, ciphertextAdd, layout.number_rotations);
+}
+
+static Ciphertext<DCRTPoly> evaluate_inner_product(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout){
+    if(ciphertexts.size() % 2 != 0){
+        throw std::invalid_argument("The inner product needs the same number of ciphertexts for both vectors");
+    }
+
+    // Multiply the chunks of both vectors and only relinearize after adding them together
+    size_t half = ciphertexts.size() / 2;
+    std::vector<Ciphertext<DCRTPoly>> multCiphertexts;
+
+    for(size_t i = 0; i < half; i++){
+        multCiphertexts.push_back(cryptoContext->EvalMultNoRelin(ciphertexts[i], ciphertexts[half + i]));
+    }
+
+    auto ciphertextAdd = cryptoContext->Relinearize(cryptoContext->EvalAddMany(multCiphertexts));
+
+    return rotate_and_sum(cryptoContext, ciphertextAdd, layout.number_rotations);
+}
+
+Ciphertext<DCRTPoly> reduce_sum_and_square_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> sumCiphertext, Ciphertext<DCRTPoly> squareSumCiphertext, const SegmentLayout& layout){
+    // Move sum(x^2) into the second segment so both sums share the same rotations
+    squareSumCiphertext = cryptoContext->EvalRotate(squareSumCiphertext, segment_rotation_index(1, layout.segment_width, layout.row_size));
+    auto resultCiphertext = cryptoContext->EvalAdd(sumCiphertext, squareSumCiphertext);
+
+    return rotate_and_sum(cryptoContext, resultCiphertext, layout.number_rotations);
+}
+
+Ciphertext<DCRTPoly> evaluate_sum_and_square_sum(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout){
+    // The squares are only relinearized once, after being added together
+    std::vector<Ciphertext<DCRTPoly>> squareCiphertexts;
+
+    for(size_t i = 0; i < ciphertexts.size(); i++){
+        squareCiphertexts.push_back(cryptoContext->EvalMultNoRelin(ciphertexts[i], ciphertexts[i]));
+    }
+
+    auto sumCiphertext = cryptoContext->EvalAddMany(ciphertexts);
+    auto squareSumCiphertext = cryptoContext->Relinearize(cryptoContext->EvalAddMany(squareCiphertexts));
+
+    return reduce_sum_and_square_sum(cryptoContext, sumCiphertext, squareSumCiphertext, layout);
+}
+
+Ciphertext<DCRTPoly> evaluate_statistic(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout){
+    if(ciphertexts.empty()){
+        throw std::invalid_argument("No ciphertexts to evaluate");
+    }
+
+    if(statistic == "mean"){
+        return evaluate_sum(cryptoContext, ciphertexts, layout);
+    }
+    if(statistic == "inner-product"){
+        return evaluate_inner_product(cryptoContext, ciphertexts, layout);
+    }
+    if(statistic == "variance"){
+        return evaluate_sum_and_square_sum(cryptoContext, ciphertexts, layout);
+    }
+
+    throw std::invalid_argument("Unknown statistic '" + statistic + "'");
+}
+
+double finish_statistic(const std::string& statistic, const std::vector<int64_t>& slots, const SegmentLayout& layout, int64_t total_elements){
+    int64_t sum = read_segment_sum(slots, 0, layout.segment_width, layout.row_size);
+
+    if(statistic == "mean"){
+        return (double)sum / total_elements;
+    }
+    if(statistic == "inner-product"){
+        return sum;
+    }
+    if(statistic == "variance"){
+        int64_t square_sum = read_segment_sum(slots, 1, layout.segment_width, layout.row_size);
+
+        // Second approach formula: (n*sum(x^2) - sum(x)^2)/n^2
+        return ((long double)total_elements * square_sum - (long double)sum * sum) / pow(total_elements, 2);
+    }
+
+    throw std::invalid_argument("Unknown statistic '" + statistic + "'");
+}
@@ -0,0 +1,47 @@
+#ifndef HOMOMORPHIC_STATISTICS_H
+#define HOMOMORPHIC_STATISTICS_H
+
+#include "auxiliaryFunctions.h"
+
+/*
+ * Statistics evaluated on slot packed ciphertexts whose values are in the first segment of each row
+ * (see pack_first_segment). Each row is split into two segments, so the variance can return
+ * sum(x) and sum(x^2) in the same ciphertext.
+ *
+ * Supported statistics:
+ *   "mean"          --> sum(x) in the first segment
+ *   "inner-product" --> sum(x*y) in the first segment, the first half of the ciphertexts is x and the second half is y
+ *   "variance"      --> sum(x) in the first segment and sum(x^2) in the second one
+ */
+
+struct SegmentLayout {
+    int64_t row_size;
+    int64_t segment_width;
+    int64_t number_rotations;
+};
+
+// BFV context used by every statistic, the plaintext modulus is big enough to hold sum(x^2) for the variance
+CryptoContext<DCRTPoly> make_statistics_context();
+
+// Generate the key pair, the relinearization key and the rotation keys needed by every statistic
+KeyPair<DCRTPoly> generate_statistics_keys(CryptoContext<DCRTPoly> cryptoContext);
+
+SegmentLayout make_segment_layout(CryptoContext<DCRTPoly> cryptoContext);
+
+// Rotation keys needed to evaluate every statistic
+std::vector<int32_t> statistics_rotation_indexes(const SegmentLayout& layout);
+
+bool is_valid_statistic(const std::string& statistic);
+
+Ciphertext<DCRTPoly> evaluate_statistic(CryptoContext<DCRTPoly> cryptoContext, const std::string& statistic, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout);
+
+// The "variance": sum(x) in the first segment and sum(x^2) in the second one, reduced by one shared rotate and sum
+Ciphertext<DCRTPoly> evaluate_sum_and_square_sum(CryptoContext<DCRTPoly> cryptoContext, const std::vector<Ciphertext<DCRTPoly>>& ciphertexts, const SegmentLayout& layout);
+
+// Reduce slot-wise sums of x and x^2 (not yet rotated and summed) into the same result layout as the "variance"
+Ciphertext<DCRTPoly> reduce_sum_and_square_sum(CryptoContext<DCRTPoly> cryptoContext, Ciphertext<DCRTPoly> sumCiphertext, Ciphertext<DCRTPoly> squareSumCiphertext, const SegmentLayout& layout);
+
+// Plaintext operations done by the data owner after decrypting the result of evaluate_statistic
+double finish_statistic(const std::string& statistic, const std::vector<int64_t>& slots, const SegmentLayout& layout, int64_t total_elements);
+
+#endif
@@ -0,0 +1,328 @@
+#include "numberFileLoader.h"
+#include "threadPool.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Same whitespace as isspace: ' ', '\t', '\n', '\v', '\f' and '\r'
+static inline bool is_whitespace(char c){
+    return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+// Bit i is set when byte i of the 16 bytes is whitespace
+static inline uint32_t whitespace_mask(const char* position){
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128((const __m128i*)position);
+
+    // '\t' to '\r' are consecutive: c - '\t' <= 4 as an unsigned byte
+    __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+    __m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+
+    return _mm_movemask_epi8(_mm_or_si128(control, space));
+#else
+    uint32_t mask = 0;
+    for(int i = 0; i < 16; i++){
+        mask |= (uint32_t)is_whitespace(position[i]) << i;
+    }
+    return mask;
+#endif
+}
+
+// Number of integers from begin to end. begin has to be a whitespace (or the start of the body)
+static uint64_t count_numbers(const char* begin, const char* end){
+    uint64_t count = 0;
+    uint32_t previous_whitespace = 1;
+    const char* position = begin;
+
+    for(; end - position >= 16; position += 16){
+        uint32_t whitespace = whitespace_mask(position);
+
+        // A number starts where a byte is not whitespace and the byte before it is
+        uint32_t starts = ~whitespace & ((whitespace << 1) | previous_whitespace) & 0xFFFF;
+
+        count += __builtin_popcount(starts);
+        previous_whitespace = whitespace >> 15;
+    }
+
+    for(; position < end; position++){
+        bool whitespace = is_whitespace(*position);
+
+        count += !whitespace && previous_whitespace;
+        previous_whitespace = whitespace;
+    }
+
+    return count;
+}
+
+static inline const char* skip_whitespace(const char* position, const char* end){
+    while(end - position >= 16){
+        uint32_t not_whitespace = ~whitespace_mask(position) & 0xFFFF;
+
+        if(not_whitespace){
+            return position + __builtin_ctz(not_whitespace);
+        }
+        position += 16;
+    }
+
+    while(position < end && is_whitespace(*position)){
+        position++;
+    }
+
+    return position;
+}
+
+// Value of the 8 digits of x (one digit per byte, the first one in the lowest byte), with 3 multiplications:
+// pairs of digits, then groups of 4 and then the 8 digits
+static inline uint64_t swar_digits_value(uint64_t x){
+    x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FF;
+    x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFF;
+    return (x * 10000 + (x >> 32)) & 0xFFFFFFFF;
+}
+
+// Parse one integer, position ends on the byte after it. Returns false if it is not a valid integer
+static inline bool parse_integer(const char*& position, const char* end, int64_t& value){
+    bool negative = false;
+    if(*position == '-' || *position == '+'){
+        negative = *position == '-';
+        position++;
+    }
+
+    const char* digits_begin = position;
+    uint64_t magnitude = 0;
+
+    // Numbers with up to 7 digits are parsed 8 bytes at a time: find the first byte that is not a digit and
+    // convert the digits before it in one go
+    if(end - position >= 8){
+        uint64_t bytes;
+        std::memcpy(&bytes, position, 8);
+
+        // High bit of every byte that is not '0' to '9' (the top bit is cleared first so no carry crosses bytes)
+        uint64_t digits = bytes ^ 0x3030303030303030;
+        uint64_t not_digit = (((digits & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | digits) & 0x8080808080808080;
+
+        if(not_digit){
+            int length = __builtin_ctzll(not_digit) / 8;
+
+            if(length > 0){
+                // Shifting the digits to the top bytes leaves zeros as the leading digits
+                magnitude = swar_digits_value(digits << (8 * (8 - length)));
+                position += length;
+            }
+        }
+    }
+
+    while(position < end && (unsigned char)(*position - '0') < 10){
+        magnitude = magnitude * 10 + (*position - '0');
+        position++;
+    }
+
+    // At most 18 digits always fit in an int64_t
+    if(position == digits_begin || position - digits_begin > 18 || (position < end && !is_whitespace(*position))){
+        return false;
+    }
+
+    value = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+
+    return true;
+}
+
+// Parse the numbers from begin to end into the vectors, starting at global index first
+static void parse_numbers(const char* begin, const char* end, uint64_t first, std::vector<std::vector<int64_t>>& vectors,
+                          int64_t size_vectors, const char* file_begin){
+    uint64_t vector = first / size_vectors;
+    int64_t index = first % size_vectors;
+    // Only looked up when there is a number to write, a block may have none and start past the last vector
+    int64_t* output = nullptr;
+
+    const char* position = skip_whitespace(begin, end);
+
+    while(position < end){
+        if(index == size_vectors){
+            vector++;
+            index = 0;
+            output = nullptr;
+        }
+        if(!output){
+            output = vectors[vector].data();
+        }
+
+        const char* number_begin = position;
+        if(!parse_integer(position, end, output[index])){
+            throw std::runtime_error("Invalid number at byte " + std::to_string(number_begin - file_begin));
+        }
+
+        index++;
+
+        // Numbers are usually separated by a single space, which does not need the 16 byte search
+        if(position + 1 < end && !is_whitespace(position[1])){
+            position++;
+        }
+        else{
+            position = skip_whitespace(position, end);
+        }
+    }
+}
+
+void parse_number_batches(const char* begin, const char* end, size_t batch_size, const std::function<void(std::vector<int64_t>&&)>& emit){
+    std::vector<int64_t> batch;
+    batch.reserve(batch_size);
+
+    const char* position = skip_whitespace(begin, end);
+
+    while(position < end){
+        int64_t value;
+        if(!parse_integer(position, end, value)){
+            throw std::runtime_error("Invalid number in the file");
+        }
+
+        batch.push_back(value);
+        if(batch.size() == batch_size){
+            emit(std::move(batch));
+
+            batch = std::vector<int64_t>();
+            batch.reserve(batch_size);
+        }
+
+        position = skip_whitespace(position, end);
+    }
+
+    if(!batch.empty()){
+        emit(std::move(batch));
+    }
+}
+
+MappedNumberFile::MappedNumberFile(const std::string& path){
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("Could not open the file - '" + path + "'");
+    }
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) < 0 || file_stat.st_size == 0){
+        close(fd);
+        throw std::runtime_error("Could not read the file - '" + path + "'");
+    }
+
+    mapped_size = file_stat.st_size;
+    void* data = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED){
+        throw std::runtime_error("Could not map the file - '" + path + "'");
+    }
+
+    madvise(data, mapped_size, MADV_SEQUENTIAL);
+
+    mapped_data = (const char*)data;
+    const char* file_end = mapped_data + mapped_size;
+
+    // Header
+    const char* position = skip_whitespace(mapped_data, file_end);
+    if(position == file_end || !parse_integer(position, file_end, number_vectors)){
+        munmap(data, mapped_size);
+        throw std::runtime_error("Missing number_vectors in '" + path + "'");
+    }
+
+    position = skip_whitespace(position, file_end);
+    if(position == file_end || !parse_integer(position, file_end, size_vectors) || number_vectors < 0 || size_vectors <= 0){
+        munmap(data, mapped_size);
+        throw std::runtime_error("Invalid header in '" + path + "'");
+    }
+
+    body = position;
+}
+
+MappedNumberFile::~MappedNumberFile(){
+    munmap((void*)mapped_data, mapped_size);
+}
+
+std::vector<std::pair<const char*, const char*>> MappedNumberFile::blocks(size_t number_blocks) const {
+    const char* file_end = mapped_data + mapped_size;
+    size_t block_size = (file_end - body) / std::max<size_t>(1, number_blocks) + 1;
+
+    // Each boundary is moved forward to a whitespace so no number is cut
+    std::vector<std::pair<const char*, const char*>> ranges;
+
+    for(const char* position = body; position < file_end; ){
+        const char* boundary = position + std::min<size_t>(block_size, file_end - position);
+
+        while(boundary < file_end && !is_whitespace(*boundary)){
+            boundary++;
+        }
+
+        ranges.push_back({position, boundary});
+        position = boundary;
+    }
+
+    return ranges;
+}
+
+NumberFile load_number_file(const std::string& path, unsigned int number_threads){
+    auto start = std::chrono::steady_clock::now();
+
+    MappedNumberFile mapped(path);
+
+    NumberFile file;
+    file.number_vectors = mapped.number_vectors;
+    file.size_vectors = mapped.size_vectors;
+    file.bytes = mapped.bytes();
+
+    // One block per thread
+    std::vector<std::pair<const char*, const char*>> blocks = mapped.blocks(number_threads);
+    ThreadPool pool(number_threads);
+
+    // First pass: count the numbers of each block
+    std::vector<std::future<uint64_t>> counted;
+    for(size_t b = 0; b < blocks.size(); b++){
+        const char* block_begin = blocks[b].first;
+        const char* block_end = blocks[b].second;
+
+        counted.push_back(pool.submit([block_begin, block_end]() { return count_numbers(block_begin, block_end); }));
+    }
+
+    // Prefix sum of the counts: index of the first number of each block
+    std::vector<uint64_t> first_index = {0};
+    for(size_t b = 0; b < blocks.size(); b++){
+        first_index.push_back(first_index.back() + counted[b].get());
+    }
+
+    if(first_index.back() != (uint64_t)(file.number_vectors * file.size_vectors)){
+        throw std::runtime_error("'" + path + "' has " + std::to_string(first_index.back()) + " numbers but its header says "
+                                 + std::to_string(file.number_vectors * file.size_vectors));
+    }
+
+    file.vectors.assign(file.number_vectors, std::vector<int64_t>(file.size_vectors));
+
+    // Second pass: every block writes its numbers straight into their place
+    std::vector<std::future<void>> parsed;
+    const char* file_begin = mapped.begin();
+
+    for(size_t b = 0; b < blocks.size(); b++){
+        const char* block_begin = blocks[b].first;
+        const char* block_end = blocks[b].second;
+        uint64_t first = first_index[b];
+
+        parsed.push_back(pool.submit([&file, block_begin, block_end, first, file_begin]() {
+            parse_numbers(block_begin, block_end, first, file.vectors, file.size_vectors, file_begin);
+        }));
+    }
+
+    // get rethrows the errors of the threads
+    for(size_t b = 0; b < parsed.size(); b++){
+        parsed[b].get();
+    }
+
+    file.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    return file;
+}
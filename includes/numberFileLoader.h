@@ -0,0 +1,71 @@
+#ifndef NUMBER_FILE_LOADER_H
+#define NUMBER_FILE_LOADER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * Loader for the number files used by the programs: a header with number_vectors and size_vectors,
+ * followed by number_vectors * size_vectors whitespace separated integers.
+ *
+ * Same result as reading the file with ifstream >>, but much faster on big files:
+ *   - The file is mapped into memory and split into one block per thread, each block starting at a whitespace.
+ *   - First pass: each thread counts the numbers of its block. The whitespace of 16 bytes at a time is found
+ *     with SSE2 compares and the numbers are the bits where a whitespace is followed by something else (popcount).
+ *   - The prefix sum of the counts gives the index of the first number of each block.
+ *   - Second pass: each thread parses its numbers straight into their place in the output vectors, skipping
+ *     the whitespace 16 bytes at a time, so no thread waits for another and nothing is copied afterwards.
+ */
+
+struct NumberFile {
+    int64_t number_vectors = 0;
+    int64_t size_vectors = 0;
+
+    // vectors[i] holds the size_vectors numbers of vector i, ready to be given to MakePackedPlaintext.
+    // Plain std::vector (default alignment): MakePackedPlaintext only takes std::vector<int64_t>, so a vector with an
+    // aligned allocator would have to be copied, and the numbers are written with scalar stores that do not need alignment
+    std::vector<std::vector<int64_t>> vectors;
+
+    // Size of the file and time spent loading it
+    uint64_t bytes = 0;
+    double milliseconds = 0;
+
+    double gigabytes_per_second() const { return milliseconds > 0 ? bytes / (milliseconds * 1e6) : 0; }
+};
+
+// Throws std::runtime_error if the file can not be read, has something other than integers or does not match its header
+NumberFile load_number_file(const std::string& path, unsigned int number_threads);
+
+/*
+ * Lower level access, for readers that do not want the whole file in memory at once (e.g. "Mean/slot_packing/pipelined-mean.cpp").
+ * The file stays mapped while the object lives, the header is read on construction.
+ */
+class MappedNumberFile {
+public:
+    explicit MappedNumberFile(const std::string& path);
+    ~MappedNumberFile();
+
+    MappedNumberFile(const MappedNumberFile&) = delete;
+    MappedNumberFile& operator=(const MappedNumberFile&) = delete;
+
+    int64_t number_vectors = 0;
+    int64_t size_vectors = 0;
+
+    const char* begin() const { return mapped_data; }
+    uint64_t bytes() const { return mapped_size; }
+
+    // The numbers after the header split into about number_blocks blocks that can be parsed independently
+    std::vector<std::pair<const char*, const char*>> blocks(size_t number_blocks) const;
+
+private:
+    const char* mapped_data;
+    size_t mapped_size;
+    const char* body;
+};
+
+// Parse the numbers of a block and call emit with every batch of batch_size numbers (the last one can be shorter)
+void parse_number_batches(const char* begin, const char* end, size_t batch_size, const std::function<void(std::vector<int64_t>&&)>& emit);
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef PARALLEL_MAP_REDUCE_H
+#define PARALLEL_MAP_REDUCE_H
+
+#include "threadPool.h"
+
+#include <stdexcept>
+
+/*
+ * Applies map to every input and reduces the mapped values with reduce, using the threads of the pool.
+ * Each task takes a contiguous block of inputs and folds every mapped value into its own accumulator
+ * as soon as it is produced, so the mapped values are never stored. At the end only one partial
+ * accumulator per task is left, and those are reduced in a tree.
+ *
+ * reduce must be associative, since the order in which the blocks are combined is not fixed.
+ */
+// Values of every future. All of them are waited for before the first exception is rethrown, so no task
+// is still running against the caller's locals once this returns or throws
+template <typename T>
+std::vector<T> get_all(std::vector<std::future<T>>& futures){
+    for(unsigned int i = 0; i < futures.size(); i++){
+        futures[i].wait();
+    }
+
+    std::vector<T> values;
+    for(unsigned int i = 0; i < futures.size(); i++){
+        values.push_back(futures[i].get());
+    }
+
+    return values;
+}
+
+template <typename T, typename Map, typename Reduce>
+T parallel_map_reduce(const std::vector<T>& inputs, Map map, Reduce reduce, ThreadPool& pool){
+    if(inputs.empty()){
+        throw std::invalid_argument("parallel_map_reduce: no inputs");
+    }
+
+    unsigned int number_tasks = std::min<size_t>(pool.size(), inputs.size());
+    size_t block_size = inputs.size() / number_tasks;
+    size_t remainder = inputs.size() % number_tasks;
+
+    std::vector<std::future<T>> partials;
+    size_t begin = 0;
+
+    for(unsigned int task = 0; task < number_tasks; task++){
+        // The first blocks take one extra input when the division is not exact
+        size_t end = begin + block_size + (task < remainder ? 1 : 0);
+
+        partials.push_back(pool.submit([&inputs, &map, &reduce, begin, end]() {
+            T accumulator = map(inputs[begin]);
+
+            for(size_t i = begin + 1; i < end; i++){
+                accumulator = reduce(accumulator, map(inputs[i]));
+            }
+
+            return accumulator;
+        }));
+
+        begin = end;
+    }
+
+    std::vector<T> results = get_all(partials);
+
+    // Reduce the partial accumulators in a tree, each level in parallel
+    while(results.size() > 1){
+        std::vector<std::future<T>> level;
+
+        for(size_t i = 0; i + 1 < results.size(); i += 2){
+            T left = results[i], right = results[i + 1];
+            level.push_back(pool.submit([&reduce, left, right]() { return reduce(left, right); }));
+        }
+
+        std::vector<T> next = get_all(level);
+
+        if(results.size() % 2 == 1){
+            next.push_back(results.back());
+        }
+
+        results = next;
+    }
+
+    return results[0];
+}
+
+#endif
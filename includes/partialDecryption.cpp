@@ -0,0 +1,65 @@
+#include "partialDecryption.h"
+
+#include <stdexcept>
+
+// Same centering as the plaintext decoding: values above t/2 are negative
+static int64_t center_value(uint64_t value, uint64_t plaintext_modulus){
+    if(value > plaintext_modulus / 2){
+        return (int64_t)value - (int64_t)plaintext_modulus;
+    }
+
+    return (int64_t)value;
+}
+
+std::vector<int64_t> decrypt_coefficients(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey,
+                                          ConstCiphertext<DCRTPoly> ciphertext, const std::vector<uint32_t>& indexes){
+    // Decrypt straight into a polynomial mod t, skipping the Plaintext and its decoding
+    NativePoly decrypted;
+
+    DecryptResult result = cryptoContext->GetScheme()->Decrypt(ciphertext, secretKey, &decrypted);
+    if(!result.isValid){
+        throw std::runtime_error("Decryption failed");
+    }
+
+    // The coefficients are the values, so the polynomial is only converted if it is not already in coefficient form
+    if(decrypted.GetFormat() != COEFFICIENT){
+        decrypted.SetFormat(COEFFICIENT);
+    }
+
+    uint64_t plaintext_modulus = cryptoContext->GetCryptoParameters()->GetPlaintextModulus();
+
+    std::vector<int64_t> values;
+    values.reserve(indexes.size());
+
+    for(size_t i = 0; i < indexes.size(); i++){
+        if(indexes[i] >= decrypted.GetLength()){
+            throw std::out_of_range("Coefficient " + std::to_string(indexes[i]) + " is outside of the plaintext");
+        }
+
+        values.push_back(center_value(decrypted[indexes[i]].ConvertToInt(), plaintext_modulus));
+    }
+
+    return values;
+}
+
+std::vector<std::vector<int64_t>> decrypt_coefficients_batch(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey,
+                                                             const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                                             const std::vector<uint32_t>& indexes, ThreadPool& pool){
+    std::vector<std::future<std::vector<int64_t>>> decryptions;
+
+    for(size_t i = 0; i < ciphertexts.size(); i++){
+        Ciphertext<DCRTPoly> ciphertext = ciphertexts[i];
+
+        decryptions.push_back(pool.submit([cryptoContext, secretKey, ciphertext, indexes]() {
+            return decrypt_coefficients(cryptoContext, secretKey, ciphertext, indexes);
+        }));
+    }
+
+    // Results come back in the same order as the ciphertexts, get rethrows any decryption error
+    std::vector<std::vector<int64_t>> values;
+    for(size_t i = 0; i < decryptions.size(); i++){
+        values.push_back(decryptions[i].get());
+    }
+
+    return values;
+}
@@ -0,0 +1,25 @@
+#ifndef PARTIAL_DECRYPTION_H
+#define PARTIAL_DECRYPTION_H
+
+#include "openfhe.h"
+#include "threadPool.h"
+
+using namespace lbcrypto;
+
+/*
+ * Decryption that only returns the plaintext values the caller needs, e.g. index 0 and ring dimension - 1
+ * for the coefficient packing mean or size - 1 for the coefficient packing inner product.
+ * Values are centered in the same way as the plaintext decoding: from -t/2 to t/2.
+ */
+
+// Coefficient packing: the decrypted polynomial already holds the values as coefficients mod t,
+// so only the requested coefficients are read, without building a Plaintext or decoding the whole vector
+std::vector<int64_t> decrypt_coefficients(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey,
+                                          ConstCiphertext<DCRTPoly> ciphertext, const std::vector<uint32_t>& indexes);
+
+// decrypt_coefficients of each ciphertext, with the decryptions split between the threads of the pool
+std::vector<std::vector<int64_t>> decrypt_coefficients_batch(CryptoContext<DCRTPoly> cryptoContext, PrivateKey<DCRTPoly> secretKey,
+                                                             const std::vector<Ciphertext<DCRTPoly>>& ciphertexts,
+                                                             const std::vector<uint32_t>& indexes, ThreadPool& pool);
+
+#endif
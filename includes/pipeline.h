@@ -0,0 +1,324 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "boundedQueue.h"
+
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Pipelined executor: each stage runs on its own threads and passes its values to the next stage through
+ * a bounded lock-free queue. While one value is being encrypted the next one is already being parsed and
+ * encoded, and a full queue stops the stages before it, so only a bounded number of values are in memory.
+ *
+ * Every stage records how long its threads were busy, waiting for input (the stage before it is too slow)
+ * and waiting for space in its output queue (the stage after it is too slow), and how full its input queue
+ * was on average. These numbers show which stage needs more threads.
+ *
+ * Stages must be added from the first to the last one: a queue is closed when all the threads of the stages
+ * writing into it are done, so those have to be registered before the next stage can see the queue empty.
+ */
+
+struct StageStatistics {
+    std::string name;
+    unsigned int number_threads = 0;
+    uint64_t items = 0;
+    double busy_ms = 0;
+    double input_stall_ms = 0;
+    double output_stall_ms = 0;
+
+    // Number of values in the input queue, sampled on every pop, and its capacity
+    uint64_t occupancy_sum = 0;
+    uint64_t occupancy_samples = 0;
+    size_t input_capacity = 0;
+
+    double input_occupancy() const { return occupancy_samples > 0 ? (double)occupancy_sum / occupancy_samples : 0; }
+};
+
+// Counters of one thread, merged into the StageStatistics when the thread ends, so the threads never share them
+struct StageCounters {
+    uint64_t items = 0;
+    double busy_ms = 0;
+    double input_stall_ms = 0;
+    double output_stall_ms = 0;
+    uint64_t occupancy_sum = 0;
+    uint64_t occupancy_samples = 0;
+};
+
+// Spin a little, then yield and finally sleep: the stages take milliseconds per value, so a long wait should not burn a core
+inline void pipeline_backoff(unsigned int& attempt){
+    if(attempt >= 128){
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    else if(attempt >= 16){
+        std::this_thread::yield();
+    }
+    attempt++;
+}
+
+inline double pipeline_elapsed_ms(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+class PipelineQueue {
+public:
+    explicit PipelineQueue(size_t capacity) : queue(capacity) {}
+
+    // Blocks while the queue is full
+    void push(T value, StageCounters& counters){
+        if(queue.try_push(value)){
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        unsigned int attempt = 0;
+
+        while(!queue.try_push(value)){
+            pipeline_backoff(attempt);
+        }
+
+        counters.output_stall_ms += pipeline_elapsed_ms(start);
+    }
+
+    // Blocks while the queue is empty. Returns false once every producer is done and the queue is empty
+    bool pop(T& value, StageCounters& counters){
+        counters.occupancy_sum += queue.size();
+        counters.occupancy_samples++;
+
+        if(queue.try_pop(value)){
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        unsigned int attempt = 0;
+
+        while(true){
+            if(queue.try_pop(value)){
+                counters.input_stall_ms += pipeline_elapsed_ms(start);
+                return true;
+            }
+
+            // A producer only finishes after its last push, so one more try after seeing no producers is enough
+            if(open_producers.load(std::memory_order_acquire) == 0){
+                bool popped = queue.try_pop(value);
+                counters.input_stall_ms += pipeline_elapsed_ms(start);
+                return popped;
+            }
+
+            pipeline_backoff(attempt);
+        }
+    }
+
+    void addProducers(unsigned int number_producers){ open_producers.fetch_add(number_producers, std::memory_order_release); }
+    void producerDone(){ open_producers.fetch_sub(1, std::memory_order_acq_rel); }
+
+    size_t capacity() const { return queue.capacity(); }
+
+private:
+    BoundedQueue<T> queue;
+    std::atomic<unsigned int> open_producers{0};
+};
+
+class Pipeline {
+public:
+    Pipeline() : start(std::chrono::steady_clock::now()) {}
+
+    ~Pipeline(){
+        for(size_t i = 0; i < threads.size(); i++){
+            if(threads[i].joinable()){
+                threads[i].join();
+            }
+        }
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // First stage: produce(thread, emit) is called once by each thread and calls emit for every value it creates
+    template <typename Out, typename Produce>
+    void addSource(const std::string& name, unsigned int number_threads, PipelineQueue<Out>& output, Produce produce){
+        StageStatistics& statistics = addStatistics(name, number_threads, 0);
+        output.addProducers(number_threads);
+
+        for(unsigned int thread = 0; thread < number_threads; thread++){
+            threads.emplace_back([this, &statistics, &output, produce, thread]() mutable {
+                StageCounters counters;
+                auto thread_start = std::chrono::steady_clock::now();
+
+                run([&]() {
+                    produce(thread, [&](Out value) {
+                        counters.items++;
+                        output.push(std::move(value), counters);
+                    });
+                });
+
+                // Everything the source does that is not waiting on its output is work
+                counters.busy_ms = pipeline_elapsed_ms(thread_start) - counters.output_stall_ms;
+
+                output.producerDone();
+                merge(statistics, counters);
+            });
+        }
+    }
+
+    // Middle stage: every value popped from input goes through transform and is pushed into output
+    template <typename In, typename Out, typename Transform>
+    void addStage(const std::string& name, unsigned int number_threads, PipelineQueue<In>& input, PipelineQueue<Out>& output, Transform transform){
+        StageStatistics& statistics = addStatistics(name, number_threads, input.capacity());
+        output.addProducers(number_threads);
+
+        for(unsigned int thread = 0; thread < number_threads; thread++){
+            threads.emplace_back([this, &statistics, &input, &output, transform]() mutable {
+                StageCounters counters;
+
+                run([&]() {
+                    In value;
+                    while(input.pop(value, counters)){
+                        auto work_start = std::chrono::steady_clock::now();
+                        Out result = transform(std::move(value));
+                        counters.busy_ms += pipeline_elapsed_ms(work_start);
+                        counters.items++;
+
+                        output.push(std::move(result), counters);
+                    }
+                }, input, counters);
+
+                output.producerDone();
+                merge(statistics, counters);
+            });
+        }
+    }
+
+    // Last stage: consume(thread, value) is called for every value popped from input
+    template <typename In, typename Consume>
+    void addSink(const std::string& name, unsigned int number_threads, PipelineQueue<In>& input, Consume consume){
+        StageStatistics& statistics = addStatistics(name, number_threads, input.capacity());
+
+        for(unsigned int thread = 0; thread < number_threads; thread++){
+            threads.emplace_back([this, &statistics, &input, consume, thread]() mutable {
+                StageCounters counters;
+
+                run([&]() {
+                    In value;
+                    while(input.pop(value, counters)){
+                        auto work_start = std::chrono::steady_clock::now();
+                        consume(thread, std::move(value));
+                        counters.busy_ms += pipeline_elapsed_ms(work_start);
+                        counters.items++;
+                    }
+                }, input, counters);
+
+                merge(statistics, counters);
+            });
+        }
+    }
+
+    // Wait for every stage to finish and rethrow the first error of a stage. Returns the time since the pipeline was created
+    double wait(){
+        for(size_t i = 0; i < threads.size(); i++){
+            threads[i].join();
+        }
+        threads.clear();
+
+        wall_ms = pipeline_elapsed_ms(start);
+
+        if(error){
+            std::rethrow_exception(error);
+        }
+
+        return wall_ms;
+    }
+
+    const std::deque<StageStatistics>& statistics() const { return stages; }
+
+    // One line per stage. Utilization is the busy time over the time the threads of the stage existed
+    void printStatistics(std::ostream& out) const {
+        out << std::fixed << std::setprecision(1);
+
+        for(size_t s = 0; s < stages.size(); s++){
+            const StageStatistics& stage = stages[s];
+            double thread_ms = wall_ms * stage.number_threads;
+
+            out << "  " << std::left << std::setw(12) << stage.name << std::right
+                << " threads " << stage.number_threads
+                << ", items " << stage.items
+                << ", utilization " << 100 * stage.busy_ms / thread_ms << "%"
+                << ", input stall " << 100 * stage.input_stall_ms / thread_ms << "%"
+                << ", output stall " << 100 * stage.output_stall_ms / thread_ms << "%";
+
+            if(stage.input_capacity > 0){
+                out << ", input queue " << stage.input_occupancy() << "/" << stage.input_capacity;
+            }
+            out << std::endl;
+        }
+
+        out << std::defaultfloat;
+    }
+
+private:
+    StageStatistics& addStatistics(const std::string& name, unsigned int number_threads, size_t input_capacity){
+        StageStatistics statistics;
+        statistics.name = name;
+        statistics.number_threads = number_threads;
+        statistics.input_capacity = input_capacity;
+
+        // A deque keeps the references valid while more stages are added
+        stages.push_back(statistics);
+
+        return stages.back();
+    }
+
+    // Keeps the first error. The thread still closes its output queue, so the stages after it do not wait forever
+    template <typename F>
+    void run(F body){
+        try{
+            body();
+        }
+        catch(...){
+            std::lock_guard<std::mutex> lock(statistics_mutex);
+            if(!error){
+                error = std::current_exception();
+            }
+        }
+    }
+
+    // Same as run, but after an error the rest of the input is thrown away, so the stages before it do not block on a full queue
+    template <typename F, typename In>
+    void run(F body, PipelineQueue<In>& input, StageCounters& counters){
+        run(body);
+
+        In value;
+        while(input.pop(value, counters)){
+        }
+    }
+
+    void merge(StageStatistics& statistics, const StageCounters& counters){
+        std::lock_guard<std::mutex> lock(statistics_mutex);
+
+        statistics.items += counters.items;
+        statistics.busy_ms += counters.busy_ms;
+        statistics.input_stall_ms += counters.input_stall_ms;
+        statistics.output_stall_ms += counters.output_stall_ms;
+
+        statistics.occupancy_sum += counters.occupancy_sum;
+        statistics.occupancy_samples += counters.occupancy_samples;
+    }
+
+    std::chrono::steady_clock::time_point start;
+    double wall_ms = 0;
+
+    std::vector<std::thread> threads;
+    std::deque<StageStatistics> stages;
+    std::mutex statistics_mutex;
+    std::exception_ptr error;
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "resultCache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <stdexcept>
+#include <sys/stat.h>
+
+std::string result_cache_key(const EncryptedDataset& dataset, const std::string& statistic, const std::string& filter, const std::string& parameters){
+    const DatasetManifest& manifest = dataset.getManifest();
+
+    return "dataset=" + manifest.id + ";generation=" + std::to_string(manifest.generation) + ";statistic=" + statistic
+           + ";filter=" + filter + ";parameters=" + parameters;
+}
+
+ResultCache::ResultCache(const std::string& directory) : directory(directory) {
+    if(mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST){
+        throw std::runtime_error("Could not create the cache directory '" + directory + "'");
+    }
+
+    // No statistics file yet is the same as a new cache
+    std::ifstream file(directory + "/statistics.txt");
+    if(file.is_open()){
+        file >> statistics.hits >> statistics.misses >> statistics.hit_milliseconds >> statistics.miss_milliseconds;
+    }
+}
+
+std::string ResultCache::entryPath(const std::string& key) const {
+    return directory + "/" + hash_bytes(key) + ".bin";
+}
+
+Ciphertext<DCRTPoly> ResultCache::lookup(const std::string& key) const {
+    std::string path = entryPath(key);
+
+    struct stat file_stat;
+    if(stat(path.c_str(), &file_stat) != 0){
+        return nullptr;
+    }
+
+    // An entry that can not be read is a miss, the query evaluates the result again and store replaces it
+    try{
+        CiphertextContainer container(path);
+        if(container.getMetadata("type") != "cached-result" || container.getMetadata("key") != key || container.size() != 1){
+            return nullptr;
+        }
+
+        return container.get(0);
+    }
+    catch(const std::exception&){
+        return nullptr;
+    }
+}
+
+uint64_t ResultCache::store(const EncryptedDataset& dataset, const std::string& key, ConstCiphertext<DCRTPoly> result, const EncryptedDataset* other) const {
+    // The datasets and generations are also kept on their own, for invalidate
+    ContainerMetadata metadata;
+    metadata["type"] = "cached-result";
+    metadata["key"] = key;
+    metadata["dataset"] = dataset.getManifest().id;
+    metadata["generation"] = std::to_string(dataset.getManifest().generation);
+
+    if(other){
+        metadata["other_dataset"] = other->getManifest().id;
+        metadata["other_generation"] = std::to_string(other->getManifest().generation);
+    }
+
+    // Write next to the old entry and rename it, so a concurrent lookup never reads half an entry
+    std::string path = entryPath(key);
+    std::string temporary_path = path + ".tmp";
+
+    ContainerWriter writer(temporary_path, metadata, 1);
+    writer.add(result);
+    uint64_t bytes = writer.finish();
+
+    if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+        throw std::runtime_error("Could not replace '" + path + "'");
+    }
+
+    return bytes;
+}
+
+size_t ResultCache::invalidate(const EncryptedDataset& dataset) const {
+    DIR* entries = opendir(directory.c_str());
+    if(!entries){
+        throw std::runtime_error("Could not read the cache directory '" + directory + "'");
+    }
+
+    const DatasetManifest& manifest = dataset.getManifest();
+    std::string generation = std::to_string(manifest.generation);
+    std::vector<std::string> stale;
+
+    for(struct dirent* entry = readdir(entries); entry; entry = readdir(entries)){
+        std::string name = entry->d_name;
+        if(name.size() < 4 || name.compare(name.size() - 4, 4, ".bin") != 0){
+            continue;
+        }
+
+        // An entry that can not be read (e.g. another file or one being replaced) is left alone
+        try{
+            CiphertextContainer container(directory + "/" + name);
+
+            bool stale_first = container.getMetadata("dataset") == manifest.id && container.getMetadata("generation") != generation;
+            bool stale_other = container.getMetadata("other_dataset") == manifest.id && container.getMetadata("other_generation") != generation;
+
+            if(stale_first || stale_other){
+                stale.push_back(directory + "/" + name);
+            }
+        }
+        catch(const std::exception&){
+            continue;
+        }
+    }
+
+    closedir(entries);
+
+    for(size_t i = 0; i < stale.size(); i++){
+        std::remove(stale[i].c_str());
+    }
+
+    return stale.size();
+}
+
+void ResultCache::record(bool hit, double milliseconds){
+    if(hit){
+        statistics.hits++;
+        statistics.hit_milliseconds += milliseconds;
+    }
+    else{
+        statistics.misses++;
+        statistics.miss_milliseconds += milliseconds;
+    }
+
+    saveStatistics();
+}
+
+void ResultCache::saveStatistics() const {
+    std::string path = directory + "/statistics.txt";
+    std::string temporary_path = path + ".tmp";
+
+    std::ofstream file(temporary_path);
+    file << statistics.hits << " " << statistics.misses << " " << statistics.hit_milliseconds << " " << statistics.miss_milliseconds << std::endl;
+    file.close();
+
+    if(file.fail() || std::rename(temporary_path.c_str(), path.c_str()) != 0){
+        throw std::runtime_error("Could not write '" + path + "'");
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "ciphertextContainer.h"
+#include "encryptedDataset.h"
+
+/*
+ * Cache of the result ciphertexts of queries over encrypted datasets, so a query repeated over an unchanged
+ * dataset is only deserialized instead of evaluated again.
+ *
+ * The key is made of the dataset id and generation, the statistic, the filter (the hash of a mask, or "none")
+ * and the parameters of the query. Every append increments the generation, so a result of an older generation
+ * is never served. invalidate, called after an append, removes those entries from the directory, including the
+ * inner products that use the dataset as their second dataset.
+ *
+ * Cache directory:
+ *   - <hash of the key>.bin, a ciphertext container with the result and the whole key in the metadata
+ *     (checked on every hit, so two keys with the same hash can not be mixed up).
+ *   - statistics.txt, the hits and misses and their total latency over every run that used the cache.
+ */
+
+struct CacheStatistics {
+    int64_t hits = 0;
+    int64_t misses = 0;
+
+    // Total time of the queries that hit and that missed, in ms
+    double hit_milliseconds = 0;
+    double miss_milliseconds = 0;
+
+    double hit_rate() const { return hits + misses > 0 ? (double)hits / (hits + misses) : 0; }
+    double average_hit_milliseconds() const { return hits > 0 ? hit_milliseconds / hits : 0; }
+    double average_miss_milliseconds() const { return misses > 0 ? miss_milliseconds / misses : 0; }
+};
+
+// Key of a query over the dataset. parameters holds anything else the result depends on (e.g. the second dataset of the inner product)
+std::string result_cache_key(const EncryptedDataset& dataset, const std::string& statistic, const std::string& filter, const std::string& parameters);
+
+class ResultCache {
+public:
+    // Create the directory if needed and load the statistics
+    explicit ResultCache(const std::string& directory);
+
+    // Cached result of the key, or nullptr if there is none or its entry can not be read
+    Ciphertext<DCRTPoly> lookup(const std::string& key) const;
+
+    // Save the result of the key, a query over the dataset (and other, the second dataset of the inner product). Returns the size of the entry in bytes
+    uint64_t store(const EncryptedDataset& dataset, const std::string& key, ConstCiphertext<DCRTPoly> result, const EncryptedDataset* other = nullptr) const;
+
+    // Remove the entries that use the dataset, as the first or the second dataset, from generations other than its current one,
+    // skipping the files that can not be read. Returns the number of entries removed
+    size_t invalidate(const EncryptedDataset& dataset) const;
+
+    // Count a query as a hit or a miss, with the time it took, and save the statistics
+    void record(bool hit, double milliseconds);
+
+    const CacheStatistics& getStatistics() const { return statistics; }
+
+private:
+    std::string entryPath(const std::string& key) const;
+
+    void saveStatistics() const;
+
+    std::string directory;
+    CacheStatistics statistics;
+};
+
+#endif
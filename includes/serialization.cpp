@@ -0,0 +1,115 @@
+#include "serialization.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+static std::string key_file(const std::string& directory, const std::string& name){
+    return directory + "/" + name;
+}
+
+void save_keys(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair){
+    if(!Serial::SerializeToFile(key_file(directory, "cryptocontext.bin"), cryptoContext, SerType::BINARY) ||
+       !Serial::SerializeToFile(key_file(directory, "public-key.bin"), keyPair.publicKey, SerType::BINARY) ||
+       !Serial::SerializeToFile(key_file(directory, "secret-key.bin"), keyPair.secretKey, SerType::BINARY)){
+        throw std::runtime_error("Could not write the keys into '" + directory + "'");
+    }
+
+    std::ofstream multKeyFile(key_file(directory, "eval-mult-key.bin"), std::ios::out | std::ios::binary);
+    if(!multKeyFile.is_open() || !cryptoContext->SerializeEvalMultKey(multKeyFile, SerType::BINARY)){
+        throw std::runtime_error("Could not write the relinearization key into '" + directory + "'");
+    }
+
+    std::ofstream rotationKeyFile(key_file(directory, "rotation-keys.bin"), std::ios::out | std::ios::binary);
+    if(!rotationKeyFile.is_open() || !cryptoContext->SerializeEvalAutomorphismKey(rotationKeyFile, SerType::BINARY)){
+        throw std::runtime_error("Could not write the rotation keys into '" + directory + "'");
+    }
+}
+
+CryptoContext<DCRTPoly> load_crypto_context(const std::string& directory){
+    CryptoContext<DCRTPoly> cryptoContext;
+
+    // Contexts are cached by OpenFHE, so release them to make sure the one from the file is used
+    CryptoContextImpl<DCRTPoly>::ClearEvalMultKeys();
+    CryptoContextImpl<DCRTPoly>::ClearEvalAutomorphismKeys();
+    CryptoContextFactory<DCRTPoly>::ReleaseAllContexts();
+
+    if(!Serial::DeserializeFromFile(key_file(directory, "cryptocontext.bin"), cryptoContext, SerType::BINARY)){
+        throw std::runtime_error("Could not read the crypto context from '" + directory + "'");
+    }
+
+    return cryptoContext;
+}
+
+CryptoContext<DCRTPoly> load_evaluation_context(const std::string& directory){
+    CryptoContext<DCRTPoly> cryptoContext = load_crypto_context(directory);
+
+    std::ifstream multKeyFile(key_file(directory, "eval-mult-key.bin"), std::ios::in | std::ios::binary);
+    if(!multKeyFile.is_open() || !cryptoContext->DeserializeEvalMultKey(multKeyFile, SerType::BINARY)){
+        throw std::runtime_error("Could not read the relinearization key from '" + directory + "'");
+    }
+
+    std::ifstream rotationKeyFile(key_file(directory, "rotation-keys.bin"), std::ios::in | std::ios::binary);
+    if(!rotationKeyFile.is_open() || !cryptoContext->DeserializeEvalAutomorphismKey(rotationKeyFile, SerType::BINARY)){
+        throw std::runtime_error("Could not read the rotation keys from '" + directory + "'");
+    }
+
+    return cryptoContext;
+}
+
+PublicKey<DCRTPoly> load_public_key(const std::string& directory){
+    PublicKey<DCRTPoly> publicKey;
+
+    if(!Serial::DeserializeFromFile(key_file(directory, "public-key.bin"), publicKey, SerType::BINARY)){
+        throw std::runtime_error("Could not read the public key from '" + directory + "'");
+    }
+
+    return publicKey;
+}
+
+PrivateKey<DCRTPoly> load_secret_key(const std::string& directory){
+    PrivateKey<DCRTPoly> secretKey;
+
+    if(!Serial::DeserializeFromFile(key_file(directory, "secret-key.bin"), secretKey, SerType::BINARY)){
+        throw std::runtime_error("Could not read the secret key from '" + directory + "'");
+    }
+
+    return secretKey;
+}
+
+std::string serialize_ciphertext(ConstCiphertext<DCRTPoly> ciphertext){
+    std::ostringstream stream(std::ios::out | std::ios::binary);
+    Serial::Serialize(ciphertext, stream, SerType::BINARY);
+
+    return stream.str();
+}
+
+Ciphertext<DCRTPoly> deserialize_ciphertext(const std::string& bytes){
+    Ciphertext<DCRTPoly> ciphertext;
+
+    std::istringstream stream(bytes, std::ios::in | std::ios::binary);
+    Serial::Deserialize(ciphertext, stream, SerType::BINARY);
+
+    return ciphertext;
+}
+
+std::string hash_bytes(const std::string& bytes){
+    uint64_t hash = 14695981039346656037ULL;
+
+    for(size_t i = 0; i < bytes.size(); i++){
+        hash = (hash ^ (unsigned char)bytes[i]) * 1099511628211ULL;
+    }
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+
+    return hex;
+}
+
+std::string context_fingerprint(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey){
+    std::ostringstream stream(std::ios::out | std::ios::binary);
+    Serial::Serialize(cryptoContext, stream, SerType::BINARY);
+    Serial::Serialize(publicKey, stream, SerType::BINARY);
+
+    return hash_bytes(stream.str());
+}
@@ -0,0 +1,43 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include "openfhe.h"
+#include "ciphertext-ser.h"
+#include "cryptocontext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bfvrns/bfvrns-ser.h"
+
+using namespace lbcrypto;
+
+/*
+ * Key directory layout, written by the data owner and read by whoever evaluates or decrypts:
+ *   cryptocontext.bin, public-key.bin, secret-key.bin, eval-mult-key.bin, rotation-keys.bin
+ * The evaluator only ever loads the context and the evaluation keys.
+ */
+
+// Write the context, the key pair and the evaluation keys (which must already be generated) into the directory
+void save_keys(const std::string& directory, CryptoContext<DCRTPoly> cryptoContext, KeyPair<DCRTPoly> keyPair);
+
+// Load only the context, enough to encrypt or decrypt
+CryptoContext<DCRTPoly> load_crypto_context(const std::string& directory);
+
+// Load the context and the relinearization and rotation keys
+CryptoContext<DCRTPoly> load_evaluation_context(const std::string& directory);
+
+PublicKey<DCRTPoly> load_public_key(const std::string& directory);
+
+PrivateKey<DCRTPoly> load_secret_key(const std::string& directory);
+
+// Binary serialization of a single ciphertext into a byte string
+std::string serialize_ciphertext(ConstCiphertext<DCRTPoly> ciphertext);
+
+Ciphertext<DCRTPoly> deserialize_ciphertext(const std::string& bytes);
+
+// 64 bit FNV-1a hash of the bytes, as 16 hex digits
+std::string hash_bytes(const std::string& bytes);
+
+// Hash (16 hex digits) of the serialized context and public key. Ciphertexts saved under one fingerprint
+// can only be used with a context and keys that give the same fingerprint
+std::string context_fingerprint(CryptoContext<DCRTPoly> cryptoContext, PublicKey<DCRTPoly> publicKey);
+
+#endif
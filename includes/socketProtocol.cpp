@@ -0,0 +1,208 @@
+#include "socketProtocol.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static sockaddr_un socket_address(const std::string& path){
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if(path.size() >= sizeof(address.sun_path)){
+        throw std::invalid_argument("Socket path is too long - '" + path + "'");
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    return address;
+}
+
+static std::runtime_error socket_error(const std::string& message){
+    return std::runtime_error(message + ": " + std::strerror(errno));
+}
+
+int listen_unix_socket(const std::string& path, int backlog){
+    sockaddr_un address = socket_address(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0){
+        throw socket_error("Could not create the socket");
+    }
+
+    unlink(path.c_str());
+
+    if(bind(fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(fd, backlog) < 0){
+        close(fd);
+        throw socket_error("Could not listen on '" + path + "'");
+    }
+
+    return fd;
+}
+
+int connect_unix_socket(const std::string& path){
+    sockaddr_un address = socket_address(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0){
+        throw socket_error("Could not create the socket");
+    }
+
+    if(connect(fd, (sockaddr*)&address, sizeof(address)) < 0){
+        close(fd);
+        throw socket_error("Could not connect to '" + path + "'");
+    }
+
+    return fd;
+}
+
+// Returns the number of bytes read, which is only smaller than size if the connection was closed
+static size_t read_all(int fd, char* buffer, size_t size){
+    size_t total = 0;
+
+    while(total < size){
+        ssize_t count = read(fd, buffer + total, size - total);
+
+        if(count < 0 && errno == EINTR){
+            continue;
+        }
+        if(count < 0){
+            throw socket_error("Could not read from the socket");
+        }
+        if(count == 0){
+            break;
+        }
+
+        total += count;
+    }
+
+    return total;
+}
+
+static void write_all(int fd, const char* buffer, size_t size){
+    size_t total = 0;
+
+    while(total < size){
+        ssize_t count = send(fd, buffer + total, size - total, MSG_NOSIGNAL);
+
+        if(count < 0 && errno == EINTR){
+            continue;
+        }
+        if(count < 0){
+            throw socket_error("Could not write to the socket");
+        }
+
+        total += count;
+    }
+}
+
+static void append_length(std::string& buffer, uint64_t length){
+    for(int i = 0; i < 8; i++){
+        buffer.push_back((char)((length >> (8 * i)) & 0xff));
+    }
+}
+
+static uint64_t parse_length(const char* bytes){
+    uint64_t length = 0;
+
+    for(int i = 0; i < 8; i++){
+        length |= (uint64_t)(unsigned char)bytes[i] << (8 * i);
+    }
+
+    return length;
+}
+
+bool read_frame(int fd, std::string& payload){
+    char header[8];
+    size_t count = read_all(fd, header, sizeof(header));
+
+    if(count == 0){
+        return false;
+    }
+    if(count < sizeof(header)){
+        throw std::runtime_error("Connection closed in the middle of a frame");
+    }
+
+    uint64_t length = parse_length(header);
+    if(length > MAX_FRAME_SIZE){
+        throw std::runtime_error("Frame of " + std::to_string(length) + " bytes is longer than the maximum of " + std::to_string(MAX_FRAME_SIZE));
+    }
+
+    payload.resize(length);
+    if(read_all(fd, &payload[0], payload.size()) < payload.size()){
+        throw std::runtime_error("Connection closed in the middle of a frame");
+    }
+
+    return true;
+}
+
+void write_frame(int fd, const std::string& payload){
+    if(payload.size() > MAX_FRAME_SIZE){
+        throw std::runtime_error("Frame of " + std::to_string(payload.size()) + " bytes is longer than the maximum of " + std::to_string(MAX_FRAME_SIZE));
+    }
+
+    std::string header;
+    append_length(header, payload.size());
+
+    write_all(fd, header.data(), header.size());
+    write_all(fd, payload.data(), payload.size());
+}
+
+std::string encode_request(const EvaluationRequest& request){
+    std::string payload;
+
+    append_length(payload, request.statistic.size());
+    payload += request.statistic;
+
+    append_length(payload, request.ciphertexts.size());
+    for(size_t i = 0; i < request.ciphertexts.size(); i++){
+        append_length(payload, request.ciphertexts[i].size());
+        payload += request.ciphertexts[i];
+    }
+
+    return payload;
+}
+
+// Reads a length prefixed field, checking it does not go past the end of the payload
+static std::string next_field(const std::string& payload, size_t& position){
+    if(payload.size() - position < 8){
+        throw std::runtime_error("Malformed request");
+    }
+
+    uint64_t length = parse_length(payload.data() + position);
+    position += 8;
+
+    if(payload.size() - position < length){
+        throw std::runtime_error("Malformed request");
+    }
+
+    std::string field = payload.substr(position, length);
+    position += length;
+
+    return field;
+}
+
+EvaluationRequest decode_request(const std::string& payload){
+    EvaluationRequest request;
+    size_t position = 0;
+
+    request.statistic = next_field(payload, position);
+
+    if(payload.size() - position < 8){
+        throw std::runtime_error("Malformed request");
+    }
+    uint64_t number_ciphertexts = parse_length(payload.data() + position);
+    position += 8;
+
+    for(uint64_t i = 0; i < number_ciphertexts; i++){
+        request.ciphertexts.push_back(next_field(payload, position));
+    }
+
+    if(position != payload.size()){
+        throw std::runtime_error("Malformed request");
+    }
+
+    return request;
+}
@@ -0,0 +1,42 @@
+#ifndef SOCKET_PROTOCOL_H
+#define SOCKET_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Framing used between the evaluation server and its clients over a Unix domain socket.
+ * Every message is a frame: 8 bytes with the payload length (little endian) followed by the payload.
+ *
+ * Request payload:  statistic name, number of ciphertexts and each serialized ciphertext, all length prefixed
+ * Response payload: 1 status byte (RESPONSE_OK or RESPONSE_ERROR) followed by the serialized ciphertext or the error message
+ */
+
+// Largest payload read_frame accepts (1 GiB), so a bad length sent by the peer can not make the reader allocate more than that
+const uint64_t MAX_FRAME_SIZE = (uint64_t)1 << 30;
+
+const char RESPONSE_OK = 0;
+const char RESPONSE_ERROR = 1;
+
+struct EvaluationRequest {
+    std::string statistic;
+    std::vector<std::string> ciphertexts;
+};
+
+// Create a socket listening on path, replacing any socket file left there
+int listen_unix_socket(const std::string& path, int backlog);
+
+int connect_unix_socket(const std::string& path);
+
+// Returns false if the other side closed the connection before a new frame started.
+// Throws std::runtime_error if the frame is longer than MAX_FRAME_SIZE
+bool read_frame(int fd, std::string& payload);
+
+void write_frame(int fd, const std::string& payload);
+
+std::string encode_request(const EvaluationRequest& request);
+
+EvaluationRequest decode_request(const std::string& payload);
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "threadPool.h"
+
+#include <exception>
+#include <stdexcept>
+
+/*
+ * Small dataflow executor. Each node is one operation that takes the values of the nodes it
+ * depends on and produces a new value. When run, every node whose inputs are ready is sent to
+ * the thread pool, so independent branches execute concurrently and a node only starts after
+ * all of its inputs are done.
+ */
+template <typename T>
+class TaskGraph {
+public:
+    typedef std::function<T(const std::vector<T>&)> Operation;
+
+    // Node with a value that is already known (e.g. the encrypted input)
+    int addInput(T value){
+        Node node;
+        node.value = value;
+        node.is_input = true;
+        nodes.push_back(node);
+
+        return nodes.size() - 1;
+    }
+
+    // Node that applies operation to the values of its dependencies, in the given order
+    int addNode(Operation operation, std::vector<int> dependencies){
+        Node node;
+        node.operation = operation;
+        node.dependencies = dependencies;
+
+        int id = nodes.size();
+        for(unsigned int i = 0; i < dependencies.size(); i++){
+            if(dependencies[i] < 0 || dependencies[i] >= id){
+                throw std::invalid_argument("TaskGraph: a node can only depend on nodes added before it");
+            }
+            nodes[dependencies[i]].dependents.push_back(id);
+        }
+
+        nodes.push_back(node);
+
+        return id;
+    }
+
+    // Execute every node on the pool and wait until the whole graph is done
+    void run(ThreadPool &pool){
+        std::unique_lock<std::mutex> lock(graph_mutex);
+
+        remaining_nodes = 0;
+        failure = nullptr;
+
+        for(unsigned int i = 0; i < nodes.size(); i++){
+            nodes[i].missing_inputs = nodes[i].dependencies.size();
+            if(!nodes[i].is_input){
+                remaining_nodes++;
+            }
+        }
+
+        // Inputs are already done, so release whatever depends only on them
+        for(unsigned int i = 0; i < nodes.size(); i++){
+            if(nodes[i].is_input){
+                releaseDependents(i, pool);
+            }
+            else if(nodes[i].dependencies.empty()){
+                schedule(i, pool);
+            }
+        }
+
+        done_condition.wait(lock, [this]() { return remaining_nodes == 0; });
+
+        if(failure){
+            std::rethrow_exception(failure);
+        }
+    }
+
+    T getResult(int node) const { return nodes[node].value; }
+
+private:
+    struct Node {
+        Operation operation;
+        std::vector<int> dependencies;
+        std::vector<int> dependents;
+        T value;
+        bool is_input = false;
+        unsigned int missing_inputs = 0;
+    };
+
+    // Must be called with graph_mutex held
+    void schedule(int id, ThreadPool &pool){
+        pool.submit([this, id, &pool]() { execute(id, pool); });
+    }
+
+    // Must be called with graph_mutex held
+    void releaseDependents(int id, ThreadPool &pool){
+        for(unsigned int i = 0; i < nodes[id].dependents.size(); i++){
+            int dependent = nodes[id].dependents[i];
+
+            nodes[dependent].missing_inputs--;
+            if(nodes[dependent].missing_inputs == 0){
+                schedule(dependent, pool);
+            }
+        }
+    }
+
+    void execute(int id, ThreadPool &pool){
+        std::vector<T> inputs;
+        bool skip;
+
+        {
+            std::lock_guard<std::mutex> lock(graph_mutex);
+            skip = failure != nullptr;
+
+            for(unsigned int i = 0; i < nodes[id].dependencies.size(); i++){
+                inputs.push_back(nodes[nodes[id].dependencies[i]].value);
+            }
+        }
+
+        T value{};
+        std::exception_ptr error = nullptr;
+
+        // Once a node fails the remaining ones are only drained, not executed
+        if(!skip){
+            try{
+                value = nodes[id].operation(inputs);
+            }
+            catch(...){
+                error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(graph_mutex);
+
+        nodes[id].value = value;
+        if(error && !failure){
+            failure = error;
+        }
+
+        releaseDependents(id, pool);
+
+        remaining_nodes--;
+        if(remaining_nodes == 0){
+            done_condition.notify_all();
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::mutex graph_mutex;
+    std::condition_variable done_condition;
+    unsigned int remaining_nodes = 0;
+    std::exception_ptr failure = nullptr;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(unsigned int number_threads){
+    if(number_threads == 0){
+        number_threads = 1;
+    }
+
+    for(unsigned int i = 0; i < number_threads; i++){
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_condition.notify_all();
+
+    // Workers only exit once the queue is empty, so every submitted task still runs
+    for(unsigned int i = 0; i < workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+void ThreadPool::workerLoop(){
+    while(true){
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            if(tasks.empty()){
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
+
+unsigned int default_number_threads(){
+    unsigned int number_threads = std::thread::hardware_concurrency();
+
+    return number_threads == 0 ? 1 : number_threads;
+}
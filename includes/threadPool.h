@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed size pool of worker threads that execute the submitted tasks in FIFO order.
+ * Tasks can submit other tasks, since no worker ever blocks waiting for another one.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int number_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task and get a future for its return value
+    template <typename F>
+    auto submit(F task) -> std::future<decltype(task())> {
+        auto packagedTask = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+        std::future<decltype(task())> result = packagedTask->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            tasks.push([packagedTask]() { (*packagedTask)(); });
+        }
+        queue_condition.notify_one();
+
+        return result;
+    }
+
+    unsigned int size() const { return workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    bool stopping = false;
+};
+
+// Number of threads to use when none is given: all the cores available
+unsigned int default_number_threads();
+
+#endif